@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "../src/flow_capacitated_networks.hpp"
+#include "../src/perf_counters.hpp"
+
+// Times each solver phase on a random network and reports hardware counters per arc processed:
+//
+//     ./benchmark [nodes] [edges per node] [seed]
+//
+// Counters include the worker threads a phase starts, such as those of the parallel construction. Counters the kernel
+// refuses, as is common in containers, are printed as "-".
+
+class PhaseReport
+{
+    public:
+        std::string name;
+        double milliseconds;
+        uint64_t arcsProcessed;
+        std::vector<std::optional<uint64_t>> counters;
+};
+
+PhaseReport runPhase(std::string name, PerfCounters& counters, std::function<uint64_t()> phase)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    counters.start();
+
+    uint64_t arcsProcessed = phase();
+
+    std::vector<std::optional<uint64_t>> readings = counters.stop();
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+
+    return { name, elapsed.count(), arcsProcessed, readings };
+};
+
+std::vector<Edge> generateEdges(uint32_t nodeCount, uint32_t edgesPerNode, uint32_t seed)
+{
+    if (nodeCount == 0) throw std::runtime_error("generateEdges: node count must be positive");
+
+    // each node has only nodeCount - 1 other nodes to point at
+    if (edgesPerNode >= nodeCount) throw std::runtime_error("generateEdges: edges per node must be less than the node count");
+
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<uint32_t> pickNode(0, nodeCount - 1);
+    std::uniform_int_distribution<int> pickCapacity(1, 100);
+
+    std::vector<Edge> edges;
+    std::vector<uint32_t> neighbors;
+
+    // every internal node hangs off the source or feeds the terminal, so augmenting paths have somewhere to go
+    for (uint32_t node = 0; node < nodeCount; node++) {
+        if (node % 2 == 0) edges.emplace_back("S", "n" + std::to_string(node), pickCapacity(random));
+        else edges.emplace_back("n" + std::to_string(node), "T", pickCapacity(random));
+
+        neighbors.clear();
+
+        for (uint32_t i = 0; i < edgesPerNode; i++) {
+            // spread over the ring with a little jitter, which can land on a neighbor already taken when there are few
+            // nodes, so repeats and self loops are dropped and a node may end up with fewer edges
+            uint32_t neighbor = (node + 1 + i * (nodeCount / (edgesPerNode + 1)) + pickNode(random) % 7) % nodeCount;
+
+            if (neighbor == node || std::find(neighbors.begin(), neighbors.end(), neighbor) != neighbors.end()) continue;
+
+            neighbors.push_back(neighbor);
+            edges.emplace_back("n" + std::to_string(node), "n" + std::to_string(neighbor), pickCapacity(random));
+        }
+    }
+
+    return edges;
+};
+
+int main(int argc, char** argv)
+{
+    try {
+        uint32_t nodeCount = argc > 1 ? std::stoul(argv[1]) : 2000;
+        uint32_t edgesPerNode = argc > 2 ? std::stoul(argv[2]) : 4;
+        uint32_t seed = argc > 3 ? std::stoul(argv[3]) : 1;
+
+        std::vector<Edge> edges = generateEdges(nodeCount, edgesPerNode, seed);
+
+        PerfCounters counters;
+
+        std::optional<FlowCapacitatedNetwork> constructed;
+
+        std::vector<PhaseReport> reports;
+
+        reports.push_back(runPhase("construct", counters, [&]() {
+            constructed = FlowCapacitatedNetwork::fromEdgeList(edges, { "S" }, { "T" });
+
+            return constructed->getResidualArcs().arcCount();
+        }));
+
+        FlowCapacitatedNetwork& network = *constructed;
+
+        const ResidualArcs& arcs = network.getResidualArcs();
+
+        SolverWorkspace workspace(arcs.nodeCount(), arcs.maxDegree());
+
+        reports.push_back(runPhase("maximize", counters, [&]() {
+            network.maximizeFlow(workspace);
+
+            return workspace.scannedArcs;
+        }));
+
+        reports.push_back(runPhase("min cut", counters, [&]() {
+            SolverWorkspace& shared = SolverWorkspace::forThread(arcs.nodeCount(), arcs.maxDegree());
+
+            uint64_t scannedBefore = shared.scannedArcs;
+
+            network.findMinCut();
+
+            return shared.scannedArcs - scannedBefore;
+        }));
+
+        std::cout << "benchmark: " << arcs.nodeCount() << " nodes, " << arcs.arcCount() << " arcs, flow " << network.getFlow();
+        std::cout << ", kernels " << residualKernelName() << ", counters " << (counters.isAvailable() ? "available, worker threads included" : "unavailable") << std::endl;
+
+        std::cout << std::left << std::setw(12) << "phase" << std::right << std::setw(12) << "ms" << std::setw(14) << "arcs";
+
+        for (const auto& counterName : PerfCounters::getCounterNames()) std::cout << std::setw(18) << counterName + "/arc";
+
+        std::cout << std::endl;
+
+        for (const auto& report : reports) {
+            std::cout << std::left << std::setw(12) << report.name << std::right << std::fixed << std::setprecision(2) << std::setw(12) << report.milliseconds << std::setw(14) << report.arcsProcessed;
+
+            for (const auto& reading : report.counters) {
+                if (reading && report.arcsProcessed > 0) std::cout << std::setw(18) << std::setprecision(3) << double(*reading) / report.arcsProcessed;
+                else std::cout << std::setw(18) << "-";
+            }
+
+            std::cout << std::endl;
+        }
+    }
+    catch (const std::exception& error) {
+        std::cerr << "benchmark: " << error.what() << std::endl;
+
+        return 1;
+    }
+
+    return 0;
+};
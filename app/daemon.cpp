@@ -0,0 +1,252 @@
+#include <iostream>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <map>
+#include <vector>
+#include <stdexcept>
+
+#include <signal.h>
+
+#include "../src/flow_capacitated_networks.hpp"
+#include "../src/line_server.hpp"
+
+// Keeps networks resident between queries so each query only pays for the augmentations it needs.
+//
+// Network files hold one or more blocks:
+//
+//     network <name>
+//     sources <node> [<node> ...]
+//     terminals <node> [<node> ...]
+//     edge <start> <end> <capacity>
+//     end
+//
+// Queries are one per line, every reply is a single line starting with "ok" or "error":
+//
+//     load <path>
+//     list
+//     maxflow <network>
+//     mincut <network>
+//     capacity <network> <start> <end> <capacity>
+//     boundary <network> <source>[,<source> ...] <terminal>[,<terminal> ...]
+//
+// load would let anyone who can reach the socket make the daemon read any file it can, so socket clients only get
+// the other queries, and the socket itself is created readable and writable by its owner only. A socket client that
+// stops reading its replies does not hold up the others.
+
+class ResidentNetwork
+{
+    public:
+        FlowCapacitatedNetwork network;
+        bool solved;
+
+        ResidentNetwork(FlowCapacitatedNetwork network): network(network), solved(false) {};
+};
+
+std::map<std::string, std::unique_ptr<ResidentNetwork>> residentNetworks;
+
+std::vector<std::string> splitWords(std::string line)
+{
+    std::vector<std::string> words;
+
+    std::istringstream stream(line);
+
+    for (std::string word; stream >> word;) words.push_back(word);
+
+    return words;
+};
+
+std::unordered_set<std::string> splitList(std::string list)
+{
+    std::unordered_set<std::string> items;
+
+    std::istringstream stream(list);
+
+    for (std::string item; std::getline(stream, item, ',');) if (!item.empty()) items.insert(item);
+
+    return items;
+};
+
+std::string joinSorted(std::unordered_set<std::string> items)
+{
+    std::vector<std::string> sortedItems(items.begin(), items.end());
+
+    std::sort(sortedItems.begin(), sortedItems.end());
+
+    std::string joined;
+
+    for (const auto& item : sortedItems) joined += (joined.empty() ? "" : ",") + item;
+
+    return joined;
+};
+
+int loadNetworks(std::string path)
+{
+    std::ifstream file(path);
+
+    if (!file) throw std::runtime_error("cannot open " + path);
+
+    int loadedCount = 0;
+
+    std::string name;
+    std::unordered_set<std::string> nodes;
+    std::unordered_set<std::string> sources;
+    std::unordered_set<std::string> terminals;
+    std::unordered_set<Edge> edges;
+
+    for (std::string line; std::getline(file, line);) {
+        std::vector<std::string> words = splitWords(line);
+
+        if (words.empty() || words[0].starts_with("#")) continue;
+
+        if (words[0] == "network" && words.size() == 2) {
+            name = words[1];
+            nodes.clear();
+            sources.clear();
+            terminals.clear();
+            edges.clear();
+        }
+        else if (words[0] == "sources" && !name.empty()) {
+            for (size_t i = 1; i < words.size(); i++) {
+                sources.insert(words[i]);
+                nodes.insert(words[i]);
+            }
+        }
+        else if (words[0] == "terminals" && !name.empty()) {
+            for (size_t i = 1; i < words.size(); i++) {
+                terminals.insert(words[i]);
+                nodes.insert(words[i]);
+            }
+        }
+        else if (words[0] == "edge" && words.size() == 4 && !name.empty()) {
+            edges.emplace(words[1], words[2], std::stoi(words[3]));
+            nodes.insert(words[1]);
+            nodes.insert(words[2]);
+        }
+        else if (words[0] == "end" && !name.empty()) {
+            residentNetworks[name] = std::make_unique<ResidentNetwork>(FlowCapacitatedNetwork::fromMultiBoundaryEdgeCapacitated(nodes, sources, terminals, edges));
+
+            name.clear();
+            loadedCount++;
+        }
+        else throw std::runtime_error("malformed line in " + path + ": " + line);
+    }
+
+    if (!name.empty()) throw std::runtime_error("network " + name + " is missing end in " + path);
+
+    return loadedCount;
+};
+
+ResidentNetwork& findNetwork(std::string name)
+{
+    auto found = residentNetworks.find(name);
+
+    if (found == residentNetworks.end()) throw std::runtime_error("unknown network " + name);
+
+    return *found->second;
+};
+
+ResidentNetwork& solvedNetwork(std::string name)
+{
+    ResidentNetwork& resident = findNetwork(name);
+
+    // queries batched between two updates share one solve
+    if (!resident.solved) {
+        resident.network.maximizeFlow();
+        resident.solved = true;
+    }
+
+    return resident;
+};
+
+std::string answerQuery(std::string line, bool allowLoad)
+{
+    std::vector<std::string> words = splitWords(line);
+
+    try {
+        if (words.empty()) throw std::runtime_error("empty query");
+
+        if (words[0] == "load" && words.size() == 2 && !allowLoad) throw std::runtime_error("load is not allowed over the socket");
+
+        if (words[0] == "load" && words.size() == 2) return "ok " + std::to_string(loadNetworks(words[1]));
+
+        if (words[0] == "list" && words.size() == 1) {
+            std::string names;
+
+            for (const auto& [name, _] : residentNetworks) names += " " + name;
+
+            return "ok" + names;
+        }
+
+        if (words[0] == "maxflow" && words.size() == 2) return "ok " + std::to_string(solvedNetwork(words[1]).network.getFlow());
+
+        if (words[0] == "mincut" && words.size() == 2) {
+            auto [sPartition, tPartition] = solvedNetwork(words[1]).network.findMinCut();
+
+            return "ok " + joinSorted(sPartition) + " " + joinSorted(tPartition);
+        }
+
+        if (words[0] == "capacity" && words.size() == 5) {
+            ResidentNetwork& resident = findNetwork(words[1]);
+
+            resident.network.setCapacity(words[2], words[3], std::stoi(words[4]));
+            resident.solved = false;
+
+            return "ok";
+        }
+
+        if (words[0] == "boundary" && words.size() == 4) {
+            ResidentNetwork& resident = findNetwork(words[1]);
+
+            resident.network.setBoundary(splitList(words[2]), splitList(words[3]));
+            resident.solved = false;
+
+            return "ok";
+        }
+
+        throw std::runtime_error("unknown query " + line);
+    }
+    catch (const std::exception& error) {
+        return std::string("error ") + error.what();
+    }
+};
+
+void serveStdio()
+{
+    for (std::string line; std::getline(std::cin, line);) std::cout << answerQuery(line, true) << std::endl;
+};
+
+void serveSocket(std::string socketPath)
+{
+    LineServer server(socketPath);
+
+    while (true) server.serveOnce([](std::string line) { return answerQuery(line, false); });
+};
+
+int main(int argc, char** argv)
+{
+    std::string socketPath;
+
+    // a client that hangs up before reading its replies must not take the daemon down with it
+    signal(SIGPIPE, SIG_IGN);
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string argument = argv[i];
+
+            if (argument == "--socket" && i + 1 < argc) socketPath = argv[++i];
+            else loadNetworks(argument);
+        }
+
+        if (socketPath.empty()) serveStdio();
+        else serveSocket(socketPath);
+    }
+    catch (const std::exception& error) {
+        std::cerr << "daemon: " << error.what() << std::endl;
+
+        return 1;
+    }
+
+    return 0;
+};
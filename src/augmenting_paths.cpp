@@ -0,0 +1,146 @@
+#include <algorithm>
+
+#include "augmenting_paths.hpp"
+
+constexpr uint32_t rootArc = UINT32_MAX;
+
+bool augmentShortestPath(const ResidualArcs& arcs, int* residuals, const std::vector<uint32_t>& sourceIndices, const std::vector<bool>& terminalMask, SolverWorkspace& workspace, std::vector<uint32_t>* pathArcs)
+{
+    workspace.reset();
+
+    size_t queueHead = 0;
+    size_t queueTail = 0;
+
+    // every source seeds the search, and the first terminal reached ends it
+    for (const auto& sourceIndex : sourceIndices) {
+        workspace.visit(sourceIndex);
+        workspace.parentArcs[sourceIndex] = rootArc;
+        workspace.queue[queueTail++] = sourceIndex;
+    }
+
+    uint32_t terminalIndex = rootArc;
+
+    while (queueHead < queueTail && terminalIndex == rootArc) {
+        uint32_t currNode = workspace.queue[queueHead++];
+        uint32_t firstArc = arcs.offsets[currNode];
+
+        workspace.scannedArcs += arcs.offsets[currNode + 1] - firstArc;
+
+        size_t selectedCount = filterPositiveResiduals(residuals + firstArc, arcs.offsets[currNode + 1] - firstArc, workspace.selected.data());
+
+        for (size_t i = 0; i < selectedCount; i++) {
+            uint32_t arc = firstArc + workspace.selected[i];
+            uint32_t neighbor = arcs.heads[arc];
+
+            if (!workspace.visit(neighbor)) continue;
+
+            workspace.parentArcs[neighbor] = arc;
+            workspace.queue[queueTail++] = neighbor;
+
+            if (terminalMask[neighbor]) {
+                terminalIndex = neighbor;
+                break;
+            }
+        }
+    }
+
+    if (terminalIndex == rootArc) return false;
+
+    size_t pathLength = 0;
+
+    for (uint32_t currNode = terminalIndex; workspace.parentArcs[currNode] != rootArc; currNode = arcs.heads[arcs.reverses[workspace.parentArcs[currNode]]]) workspace.path[pathLength++] = workspace.parentArcs[currNode];
+
+    int bottleneck = minResidual(residuals, workspace.path.data(), pathLength);
+
+    for (size_t i = 0; i < pathLength; i++) {
+        residuals[workspace.path[i]] -= bottleneck;
+        residuals[arcs.reverses[workspace.path[i]]] += bottleneck;
+    }
+
+    if (pathArcs) pathArcs->insert(pathArcs->end(), workspace.path.begin(), workspace.path.begin() + pathLength);
+
+    return true;
+};
+
+void markReachable(const ResidualArcs& arcs, const int* residuals, const std::vector<uint32_t>& sourceIndices, SolverWorkspace& workspace)
+{
+    workspace.reset();
+
+    size_t queueTail = 0;
+
+    for (const auto& sourceIndex : sourceIndices) {
+        workspace.visit(sourceIndex);
+        workspace.queue[queueTail++] = sourceIndex;
+    }
+
+    for (size_t queueHead = 0; queueHead < queueTail; queueHead++) {
+        uint32_t currNode = workspace.queue[queueHead];
+
+        workspace.scannedArcs += arcs.offsets[currNode + 1] - arcs.offsets[currNode];
+
+        for (uint32_t arc = arcs.offsets[currNode]; arc < arcs.offsets[currNode + 1]; arc++) {
+            if (residuals[arc] > 0 && workspace.visit(arcs.heads[arc])) workspace.queue[queueTail++] = arcs.heads[arc];
+        }
+    }
+};
+
+int64_t residualLayerCutBound(const ResidualArcs& arcs, const int* residuals, const std::vector<uint32_t>& sourceIndices, const std::vector<bool>& terminalMask, SolverWorkspace& workspace)
+{
+    constexpr uint32_t unreached = UINT32_MAX;
+
+    workspace.reset();
+
+    // path is free during this search, so it holds the layer of every visited node
+    std::span<uint32_t> distances = workspace.path;
+
+    size_t queueTail = 0;
+
+    for (const auto& sourceIndex : sourceIndices) {
+        workspace.visit(sourceIndex);
+        distances[sourceIndex] = 0;
+        workspace.queue[queueTail++] = sourceIndex;
+    }
+
+    uint32_t terminalDistance = unreached;
+
+    // residual arcs out of a layer reach at most the next one, so the arcs into the next layer are the whole cut
+    uint32_t layer = 0;
+    int64_t layerCrossing = 0;
+    int64_t bound = INT64_MAX;
+
+    for (size_t queueHead = 0; queueHead < queueTail; queueHead++) {
+        uint32_t currNode = workspace.queue[queueHead];
+
+        if (distances[currNode] >= terminalDistance) break;
+
+        if (distances[currNode] != layer) {
+            bound = std::min(bound, layerCrossing);
+            layer = distances[currNode];
+            layerCrossing = 0;
+        }
+
+        for (uint32_t arc = arcs.offsets[currNode]; arc < arcs.offsets[currNode + 1]; arc++) {
+            if (residuals[arc] <= 0) continue;
+
+            uint32_t neighbor = arcs.heads[arc];
+
+            if (workspace.visit(neighbor)) {
+                distances[neighbor] = layer + 1;
+                workspace.queue[queueTail++] = neighbor;
+
+                if (terminalMask[neighbor]) terminalDistance = std::min(terminalDistance, layer + 1);
+            }
+
+            if (distances[neighbor] == layer + 1) layerCrossing += residuals[arc];
+        }
+    }
+
+    if (terminalDistance == unreached) return 0;
+
+    return std::min(bound, layerCrossing);
+};
+
+SolverWorkspace& workspaceFor(const ResidualArcs& arcs)
+{
+    return SolverWorkspace::forThread(arcs.nodeCount(), arcs.maxDegree());
+};
@@ -0,0 +1,20 @@
+#ifndef AUGMENTING_PATHS
+#define AUGMENTING_PATHS
+
+#include "residual_arcs.hpp"
+#include "solver_workspace.hpp"
+
+// residuals is passed apart from arcs so callers can run the search over residual state they own
+
+// pathArcs, when given, gets the arcs of the augmented path appended so callers can track what changed
+bool augmentShortestPath(const ResidualArcs& arcs, int* residuals, const std::vector<uint32_t>& sourceIndices, const std::vector<bool>& terminalMask, SolverWorkspace& workspace, std::vector<uint32_t>* pathArcs = nullptr);
+
+void markReachable(const ResidualArcs& arcs, const int* residuals, const std::vector<uint32_t>& sourceIndices, SolverWorkspace& workspace);
+
+// Smallest residual capacity leaving any breadth first layer cut that separates the sources from every terminal.
+// The current flow plus this is an upper bound on the maximum flow, and it is 0 once no augmenting path is left.
+int64_t residualLayerCutBound(const ResidualArcs& arcs, const int* residuals, const std::vector<uint32_t>& sourceIndices, const std::vector<bool>& terminalMask, SolverWorkspace& workspace);
+
+SolverWorkspace& workspaceFor(const ResidualArcs& arcs);
+
+#endif
@@ -0,0 +1,216 @@
+#include "bipartite_matching.hpp"
+
+constexpr uint32_t noNode = UINT32_MAX;
+
+enum class BipartiteLayer : uint8_t { none, source, left, right, terminal };
+
+class BipartiteShape
+{
+    public:
+        std::vector<uint32_t> leftNodes;
+        std::vector<uint32_t> rightNodes;
+
+        // leftIndex[node] / rightIndex[node] is the position of node in its layer
+        std::vector<uint32_t> leftIndex;
+        std::vector<uint32_t> rightIndex;
+
+        // the source arc feeding each left node and the terminal arc draining each right node
+        std::vector<uint32_t> sourceArcs;
+        std::vector<uint32_t> terminalArcs;
+};
+
+bool detectUnitBipartite(const ResidualArcs& arcs, const std::vector<uint32_t>& sourceIndices, const std::vector<bool>& terminalMask, BipartiteShape& shape)
+{
+    uint32_t nodeCount = arcs.nodeCount();
+
+    std::vector<BipartiteLayer> layers(nodeCount, BipartiteLayer::none);
+
+    for (const auto& sourceIndex : sourceIndices) layers[sourceIndex] = BipartiteLayer::source;
+    for (uint32_t node = 0; node < nodeCount; node++) if (terminalMask[node]) layers[node] = BipartiteLayer::terminal;
+
+    shape.leftIndex.assign(nodeCount, noNode);
+    shape.rightIndex.assign(nodeCount, noNode);
+
+    for (uint32_t arc = 0; arc < arcs.arcCount(); arc++) {
+        if (arcs.forward[arc] && (arcs.capacities[arc] > 1 || arcs.residuals[arc] != arcs.capacities[arc])) return false;
+    }
+
+    for (const auto& sourceIndex : sourceIndices) {
+        for (uint32_t arc = arcs.offsets[sourceIndex]; arc < arcs.offsets[sourceIndex + 1]; arc++) {
+            uint32_t head = arcs.heads[arc];
+
+            if (!arcs.forward[arc] || arcs.capacities[arc] == 0) continue;
+            if (layers[head] != BipartiteLayer::none) return false;
+
+            layers[head] = BipartiteLayer::left;
+            shape.leftIndex[head] = shape.leftNodes.size();
+            shape.leftNodes.push_back(head);
+            shape.sourceArcs.push_back(arc);
+        }
+    }
+
+    for (const auto& left : shape.leftNodes) {
+        for (uint32_t arc = arcs.offsets[left]; arc < arcs.offsets[left + 1]; arc++) {
+            uint32_t head = arcs.heads[arc];
+
+            if (!arcs.forward[arc] || arcs.capacities[arc] == 0) continue;
+            if (layers[head] == BipartiteLayer::right) continue;
+            if (layers[head] != BipartiteLayer::none) return false;
+
+            layers[head] = BipartiteLayer::right;
+            shape.rightIndex[head] = shape.rightNodes.size();
+            shape.rightNodes.push_back(head);
+            shape.terminalArcs.push_back(noNode);
+        }
+    }
+
+    // every remaining positive edge must leave a right node for a terminal, at most once per right node
+    for (uint32_t node = 0; node < nodeCount; node++) {
+        for (uint32_t arc = arcs.offsets[node]; arc < arcs.offsets[node + 1]; arc++) {
+            if (!arcs.forward[arc] || arcs.capacities[arc] == 0) continue;
+
+            BipartiteLayer headLayer = layers[arcs.heads[arc]];
+
+            if (layers[node] == BipartiteLayer::source || layers[node] == BipartiteLayer::left) continue;
+
+            // a right node no left node reaches still drains into a terminal, it just never gets matched
+            if (layers[node] == BipartiteLayer::none && headLayer == BipartiteLayer::terminal) {
+                layers[node] = BipartiteLayer::right;
+                shape.rightIndex[node] = shape.rightNodes.size();
+                shape.rightNodes.push_back(node);
+                shape.terminalArcs.push_back(noNode);
+            }
+
+            if (layers[node] != BipartiteLayer::right || headLayer != BipartiteLayer::terminal) return false;
+
+            uint32_t& terminalArc = shape.terminalArcs[shape.rightIndex[node]];
+
+            if (terminalArc != noNode) return false;
+
+            terminalArc = arc;
+        }
+    }
+
+    for (const auto& terminalArc : shape.terminalArcs) if (terminalArc == noNode) return false;
+
+    return !shape.leftNodes.empty();
+};
+
+bool solveUnitBipartite(ResidualArcs& arcs, const std::vector<uint32_t>& sourceIndices, const std::vector<bool>& terminalMask)
+{
+    BipartiteShape shape;
+
+    if (!detectUnitBipartite(arcs, sourceIndices, terminalMask, shape)) return false;
+
+    uint32_t leftCount = shape.leftNodes.size();
+    uint32_t rightCount = shape.rightNodes.size();
+
+    // compact left -> right adjacency, keeping the arc so the matching can be written back
+    std::vector<uint32_t> adjacencyOffsets(leftCount + 1, 0);
+    std::vector<uint32_t> adjacencyRights;
+    std::vector<uint32_t> adjacencyArcs;
+
+    for (uint32_t left = 0; left < leftCount; left++) {
+        uint32_t node = shape.leftNodes[left];
+
+        for (uint32_t arc = arcs.offsets[node]; arc < arcs.offsets[node + 1]; arc++) {
+            if (!arcs.forward[arc] || arcs.capacities[arc] == 0) continue;
+
+            adjacencyRights.push_back(shape.rightIndex[arcs.heads[arc]]);
+            adjacencyArcs.push_back(arc);
+        }
+
+        adjacencyOffsets[left + 1] = adjacencyRights.size();
+    }
+
+    constexpr uint32_t unreached = UINT32_MAX;
+
+    std::vector<uint32_t> leftMatches(leftCount, noNode);
+    std::vector<uint32_t> rightMatches(rightCount, noNode);
+    std::vector<uint32_t> distances(leftCount);
+    std::vector<uint32_t> nextEdges(leftCount);
+    std::vector<uint32_t> queue;
+    std::vector<uint32_t> stack;
+
+    while (true) {
+        queue.clear();
+
+        for (uint32_t left = 0; left < leftCount; left++) {
+            distances[left] = leftMatches[left] == noNode ? 0 : unreached;
+
+            if (distances[left] == 0) queue.push_back(left);
+        }
+
+        // layering stops at the first layer that reaches a free right node, so every path the search below
+        // augments is a shortest one, which is what bounds the phases to O(sqrt(V))
+        uint32_t freeDistance = unreached;
+        size_t queueHead = 0;
+
+        for (; queueHead < queue.size() && distances[queue[queueHead]] <= freeDistance; queueHead++) {
+            uint32_t left = queue[queueHead];
+
+            for (uint32_t edge = adjacencyOffsets[left]; edge < adjacencyOffsets[left + 1]; edge++) {
+                uint32_t matchedLeft = rightMatches[adjacencyRights[edge]];
+
+                if (matchedLeft == noNode) freeDistance = distances[left];
+                else if (distances[matchedLeft] == unreached && distances[left] < freeDistance) {
+                    distances[matchedLeft] = distances[left] + 1;
+                    queue.push_back(matchedLeft);
+                }
+            }
+        }
+
+        if (freeDistance == unreached) break;
+
+        // left nodes layered past the free layer before it was found are left out of this phase
+        for (; queueHead < queue.size(); queueHead++) distances[queue[queueHead]] = unreached;
+
+        for (uint32_t left = 0; left < leftCount; left++) nextEdges[left] = adjacencyOffsets[left];
+
+        // iterative depth first search for vertex disjoint shortest augmenting paths
+        for (uint32_t start = 0; start < leftCount; start++) {
+            if (leftMatches[start] != noNode || distances[start] != 0) continue;
+
+            stack.assign(1, start);
+
+            while (!stack.empty()) {
+                uint32_t left = stack.back();
+
+                if (nextEdges[left] == adjacencyOffsets[left + 1]) {
+                    distances[left] = unreached;
+                    stack.pop_back();
+                    continue;
+                }
+
+                uint32_t matchedLeft = rightMatches[adjacencyRights[nextEdges[left]]];
+
+                if (matchedLeft == noNode) {
+                    for (const auto& pathLeft : stack) {
+                        uint32_t edge = nextEdges[pathLeft];
+
+                        leftMatches[pathLeft] = edge;
+                        rightMatches[adjacencyRights[edge]] = pathLeft;
+                    }
+
+                    break;
+                }
+
+                if (distances[matchedLeft] == distances[left] + 1) stack.push_back(matchedLeft);
+                else nextEdges[left]++;
+            }
+        }
+    }
+
+    for (uint32_t left = 0; left < leftCount; left++) {
+        if (leftMatches[left] == noNode) continue;
+
+        uint32_t right = adjacencyRights[leftMatches[left]];
+
+        for (const auto& arc : { shape.sourceArcs[left], adjacencyArcs[leftMatches[left]], shape.terminalArcs[right] }) {
+            arcs.residuals[arc] = 0;
+            arcs.residuals[arcs.reverses[arc]] = 1;
+        }
+    }
+
+    return true;
+};
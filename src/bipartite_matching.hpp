@@ -0,0 +1,12 @@
+#ifndef BIPARTITE_MATCHING
+#define BIPARTITE_MATCHING
+
+#include "residual_arcs.hpp"
+
+// Solves the network as a maximum matching when it is a zero flow, unit capacity assignment network:
+// every edge runs source -> left, left -> right or right -> terminal, each left node has one edge in from a source
+// and each right node has one edge out to a terminal. The matching is written back into the residuals.
+// Returns false and leaves the network untouched for any other shape.
+bool solveUnitBipartite(ResidualArcs& arcs, const std::vector<uint32_t>& sourceIndices, const std::vector<bool>& terminalMask);
+
+#endif
@@ -0,0 +1,216 @@
+#include <algorithm>
+
+#include "criticality_analysis.hpp"
+
+// residual graph with a virtual super source and super terminal appended, so multiple sources and terminals
+// behave like the single source and terminal the cut characterizations are stated for
+class ResidualGraph
+{
+    public:
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> heads;
+
+        ResidualGraph(const FlowCapacitatedNetwork& network);
+};
+
+ResidualGraph::ResidualGraph(const FlowCapacitatedNetwork& network)
+{
+    const ResidualArcs& arcs = network.getResidualArcs();
+
+    uint32_t nodeCount = arcs.nodeCount();
+    uint32_t superSource = nodeCount;
+    uint32_t superTerminal = nodeCount + 1;
+
+    std::vector<std::vector<uint32_t>> virtualArcs(nodeCount + 2);
+
+    for (const auto& sourceIndex : network.getSourceIndices()) {
+        virtualArcs[superSource].push_back(sourceIndex);
+
+        int outflow = 0;
+
+        for (uint32_t arc = arcs.offsets[sourceIndex]; arc < arcs.offsets[sourceIndex + 1]; arc++) outflow += arcs.flow(arc);
+
+        if (outflow > 0) virtualArcs[sourceIndex].push_back(superSource);
+    }
+
+    for (const auto& terminalIndex : network.getTerminalIndices()) {
+        virtualArcs[terminalIndex].push_back(superTerminal);
+
+        int inflow = 0;
+
+        for (uint32_t arc = arcs.offsets[terminalIndex]; arc < arcs.offsets[terminalIndex + 1]; arc++) inflow += arcs.flow(arcs.reverses[arc]);
+
+        if (inflow > 0) virtualArcs[superTerminal].push_back(terminalIndex);
+    }
+
+    this->offsets.push_back(0);
+
+    for (uint32_t node = 0; node < nodeCount + 2; node++) {
+        if (node < nodeCount) {
+            for (uint32_t arc = arcs.offsets[node]; arc < arcs.offsets[node + 1]; arc++) if (arcs.residual(arc) > 0) this->heads.push_back(arcs.heads[arc]);
+        }
+
+        for (const auto& head : virtualArcs[node]) this->heads.push_back(head);
+
+        this->offsets.push_back(this->heads.size());
+    }
+};
+
+std::vector<bool> findReachable(const ResidualGraph& graph, uint32_t start)
+{
+    std::vector<bool> reachable(graph.offsets.size() - 1, false);
+    std::vector<uint32_t> queue = { start };
+
+    reachable[start] = true;
+
+    for (size_t queueHead = 0; queueHead < queue.size(); queueHead++) {
+        uint32_t currNode = queue[queueHead];
+
+        for (uint32_t i = graph.offsets[currNode]; i < graph.offsets[currNode + 1]; i++) {
+            if (!reachable[graph.heads[i]]) {
+                reachable[graph.heads[i]] = true;
+                queue.push_back(graph.heads[i]);
+            }
+        }
+    }
+
+    return reachable;
+};
+
+std::vector<bool> findCoreachable(const ResidualGraph& graph, uint32_t end)
+{
+    uint32_t nodeCount = graph.offsets.size() - 1;
+
+    ResidualGraph reversed = graph;
+
+    std::vector<uint32_t> inDegrees(nodeCount + 1, 0);
+
+    for (const auto& head : graph.heads) inDegrees[head + 1]++;
+    for (uint32_t node = 0; node < nodeCount; node++) inDegrees[node + 1] += inDegrees[node];
+
+    reversed.offsets = inDegrees;
+
+    std::vector<uint32_t> nextSlot(inDegrees.begin(), inDegrees.end() - 1);
+
+    for (uint32_t node = 0; node < nodeCount; node++) {
+        for (uint32_t i = graph.offsets[node]; i < graph.offsets[node + 1]; i++) reversed.heads[nextSlot[graph.heads[i]]++] = node;
+    }
+
+    return findReachable(reversed, end);
+};
+
+// iterative tarjan, components[v] is the strongly connected component of v
+std::vector<uint32_t> findStronglyConnectedComponents(const ResidualGraph& graph)
+{
+    constexpr uint32_t unindexed = UINT32_MAX;
+
+    uint32_t nodeCount = graph.offsets.size() - 1;
+
+    std::vector<uint32_t> indices(nodeCount, unindexed);
+    std::vector<uint32_t> lowLinks(nodeCount, 0);
+    std::vector<uint32_t> components(nodeCount, unindexed);
+    std::vector<bool> onStack(nodeCount, false);
+
+    std::vector<uint32_t> componentStack;
+    std::vector<std::pair<uint32_t, uint32_t>> callStack;
+
+    uint32_t nextIndex = 0;
+    uint32_t componentCount = 0;
+
+    for (uint32_t start = 0; start < nodeCount; start++) {
+        if (indices[start] != unindexed) continue;
+
+        callStack.emplace_back(start, graph.offsets[start]);
+
+        while (!callStack.empty()) {
+            auto& [node, nextArc] = callStack.back();
+
+            if (nextArc == graph.offsets[node] && indices[node] == unindexed) {
+                indices[node] = lowLinks[node] = nextIndex++;
+                componentStack.push_back(node);
+                onStack[node] = true;
+            }
+
+            if (nextArc < graph.offsets[node + 1]) {
+                uint32_t head = graph.heads[nextArc++];
+
+                if (indices[head] == unindexed) callStack.emplace_back(head, graph.offsets[head]);
+                else if (onStack[head]) lowLinks[node] = std::min(lowLinks[node], indices[head]);
+
+                continue;
+            }
+
+            if (lowLinks[node] == indices[node]) {
+                uint32_t member;
+
+                do {
+                    member = componentStack.back();
+                    componentStack.pop_back();
+                    onStack[member] = false;
+                    components[member] = componentCount;
+                } while (member != node);
+
+                componentCount++;
+            }
+
+            uint32_t finished = node;
+            callStack.pop_back();
+
+            if (!callStack.empty()) {
+                uint32_t caller = callStack.back().first;
+
+                lowLinks[caller] = std::min(lowLinks[caller], lowLinks[finished]);
+            }
+        }
+    }
+
+    return components;
+};
+
+CriticalityReport analyzeCriticality(FlowCapacitatedNetwork& network)
+{
+    network.restoreReverseArcs();
+
+    if (!network.isMaxFlow()) network.maximizeFlow();
+
+    const ResidualArcs& arcs = network.getResidualArcs();
+    const std::vector<std::string>& nodes = network.getNodes();
+
+    uint32_t nodeCount = arcs.nodeCount();
+
+    ResidualGraph graph(network);
+
+    std::vector<bool> reachableFromSource = findReachable(graph, nodeCount);
+    std::vector<bool> reachesTerminal = findCoreachable(graph, nodeCount + 1);
+    std::vector<uint32_t> components = findStronglyConnectedComponents(graph);
+
+    CriticalityReport report;
+
+    for (uint32_t start = 0; start < nodeCount; start++) {
+        for (uint32_t arc = arcs.offsets[start]; arc < arcs.offsets[start + 1]; arc++) {
+            if (!arcs.forward[arc] || arcs.residual(arc) > 0) continue;
+
+            uint32_t end = arcs.heads[arc];
+
+            // a saturated edge lies on some min cut exactly when the residual graph has no path back across it
+            bool downwardCritical = arcs.capacities[arc] > 0 && components[start] != components[end];
+            bool upwardCritical = reachableFromSource[start] && reachesTerminal[end];
+
+            std::string originalStart = network.getOriginalNode(start);
+            std::string originalEnd = network.getOriginalNode(end);
+
+            if (network.isVertexSplit() && originalStart == originalEnd) {
+                if (!nodes[start].ends_with("-in")) continue;
+
+                if (downwardCritical) report.downwardCriticalVertices.insert(originalStart);
+                if (upwardCritical) report.upwardCriticalVertices.insert(originalStart);
+            }
+            else {
+                if (downwardCritical) report.downwardCriticalEdges.emplace(originalStart, originalEnd);
+                if (upwardCritical) report.upwardCriticalEdges.emplace(originalStart, originalEnd);
+            }
+        }
+    }
+
+    return report;
+};
@@ -0,0 +1,22 @@
+#ifndef CRITICALITY_ANALYSIS
+#define CRITICALITY_ANALYSIS
+
+#include "flow_capacitated_networks.hpp"
+
+// Edges and vertices are reported by their original names, never by their -in/-out split nodes.
+//
+// upward critical: raising the capacity raises the max flow
+// downward critical: every max flow saturates it, so lowering the capacity lowers the max flow
+class CriticalityReport
+{
+    public:
+        std::unordered_set<std::pair<std::string, std::string>> upwardCriticalEdges;
+        std::unordered_set<std::pair<std::string, std::string>> downwardCriticalEdges;
+
+        std::unordered_set<std::string> upwardCriticalVertices;
+        std::unordered_set<std::string> downwardCriticalVertices;
+};
+
+CriticalityReport analyzeCriticality(FlowCapacitatedNetwork& network);
+
+#endif
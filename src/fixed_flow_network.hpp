@@ -0,0 +1,203 @@
+#ifndef FIXED_FLOW_NETWORK
+#define FIXED_FLOW_NETWORK
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+
+// Header only network for tiny graphs on hot paths. Nodes are the indices 0 .. NodeCount - 1, residuals live in a
+// fixed adjacency matrix with one bitmask row per node, so building and solving never touches the heap and every
+// method can run in a constant expression. Node sets, such as the source side of a min cut, are bitmasks.
+template <uint32_t NodeCount>
+class FixedFlowNetwork
+{
+    static_assert(NodeCount > 0 && NodeCount <= 64, "FixedFlowNetwork: node sets are 64 bit masks");
+
+    private:
+        std::array<std::array<int, NodeCount>, NodeCount> capacities {};
+        std::array<std::array<int, NodeCount>, NodeCount> residuals {};
+
+        // bit v of residualMasks[u] is set while residuals[u][v] > 0
+        std::array<uint64_t, NodeCount> residualMasks {};
+
+        uint64_t sourceMask = 0;
+        uint64_t terminalMask = 0;
+
+        constexpr void setResidual(uint32_t start, uint32_t end, int residual);
+        constexpr uint64_t findReachable() const;
+
+    public:
+        constexpr FixedFlowNetwork() = default;
+
+        constexpr void addSource(uint32_t node);
+        constexpr void addTerminal(uint32_t node);
+        constexpr void addEdge(uint32_t start, uint32_t end, int capacity);
+
+        constexpr int getFlow() const;
+        constexpr int getEdgeFlow(uint32_t start, uint32_t end) const;
+
+        // bitmask of the nodes on the source side
+        constexpr uint64_t findMinCut() const;
+
+        constexpr bool isMaxFlow() const;
+
+        constexpr bool augment();
+        constexpr void maximizeFlow();
+
+        constexpr void resetFlow();
+};
+
+template <uint32_t NodeCount>
+constexpr void FixedFlowNetwork<NodeCount>::setResidual(uint32_t start, uint32_t end, int residual)
+{
+    this->residuals[start][end] = residual;
+
+    if (residual > 0) this->residualMasks[start] |= uint64_t(1) << end;
+    else this->residualMasks[start] &= ~(uint64_t(1) << end);
+};
+
+template <uint32_t NodeCount>
+constexpr uint64_t FixedFlowNetwork<NodeCount>::findReachable() const
+{
+    uint64_t visited = this->sourceMask;
+
+    for (uint64_t frontier = visited; frontier;) {
+        uint64_t next = 0;
+
+        for (; frontier; frontier &= frontier - 1) next |= this->residualMasks[std::countr_zero(frontier)];
+
+        frontier = next & ~visited;
+        visited |= frontier;
+    }
+
+    return visited;
+};
+
+template <uint32_t NodeCount>
+constexpr void FixedFlowNetwork<NodeCount>::addSource(uint32_t node)
+{
+    if (node >= NodeCount) throw std::runtime_error("FixedFlowNetwork addSource: node is out of range");
+    if ((this->terminalMask >> node) & 1) throw std::runtime_error("FixedFlowNetwork addSource: node is already a terminal");
+
+    this->sourceMask |= uint64_t(1) << node;
+};
+
+template <uint32_t NodeCount>
+constexpr void FixedFlowNetwork<NodeCount>::addTerminal(uint32_t node)
+{
+    if (node >= NodeCount) throw std::runtime_error("FixedFlowNetwork addTerminal: node is out of range");
+    if ((this->sourceMask >> node) & 1) throw std::runtime_error("FixedFlowNetwork addTerminal: node is already a source");
+
+    this->terminalMask |= uint64_t(1) << node;
+};
+
+template <uint32_t NodeCount>
+constexpr void FixedFlowNetwork<NodeCount>::addEdge(uint32_t start, uint32_t end, int capacity)
+{
+    if (start >= NodeCount || end >= NodeCount) throw std::runtime_error("FixedFlowNetwork addEdge: edge contains invalid node");
+    if (start == end) throw std::runtime_error("FixedFlowNetwork addEdge: edge cannot be a loop");
+    if (capacity < 0) throw std::runtime_error("FixedFlowNetwork addEdge: edge capacity cannot be negative");
+
+    // repeated edges add up, and any flow already routed stays in place
+    this->capacities[start][end] += capacity;
+    this->setResidual(start, end, this->residuals[start][end] + capacity);
+};
+
+template <uint32_t NodeCount>
+constexpr int FixedFlowNetwork<NodeCount>::getFlow() const
+{
+    int flow = 0;
+
+    // flow between two sources cancels out, leaving only what leaves the source set
+    for (uint64_t sources = this->sourceMask; sources; sources &= sources - 1) {
+        uint32_t source = std::countr_zero(sources);
+
+        for (uint32_t node = 0; node < NodeCount; node++) flow += this->capacities[source][node] - this->residuals[source][node];
+    }
+
+    return flow;
+};
+
+template <uint32_t NodeCount>
+constexpr int FixedFlowNetwork<NodeCount>::getEdgeFlow(uint32_t start, uint32_t end) const
+{
+    int flow = this->capacities[start][end] - this->residuals[start][end];
+
+    return flow > 0 ? flow : 0;
+};
+
+template <uint32_t NodeCount>
+constexpr uint64_t FixedFlowNetwork<NodeCount>::findMinCut() const
+{
+    return this->findReachable();
+};
+
+template <uint32_t NodeCount>
+constexpr bool FixedFlowNetwork<NodeCount>::isMaxFlow() const
+{
+    return (this->findReachable() & this->terminalMask) == 0;
+};
+
+template <uint32_t NodeCount>
+constexpr bool FixedFlowNetwork<NodeCount>::augment()
+{
+    std::array<uint32_t, NodeCount> parents {};
+
+    uint64_t visited = this->sourceMask;
+    uint64_t reachedTerminals = 0;
+
+    // each round expands the whole frontier at once, so the first terminal found ends a shortest path
+    for (uint64_t frontier = visited; frontier && !reachedTerminals;) {
+        uint64_t next = 0;
+
+        for (; frontier && !reachedTerminals; frontier &= frontier - 1) {
+            uint32_t node = std::countr_zero(frontier);
+
+            uint64_t discovered = this->residualMasks[node] & ~visited & ~next;
+
+            for (uint64_t bits = discovered; bits; bits &= bits - 1) parents[std::countr_zero(bits)] = node;
+
+            next |= discovered;
+            reachedTerminals = discovered & this->terminalMask;
+        }
+
+        visited |= next;
+        frontier = next;
+    }
+
+    if (!reachedTerminals) return false;
+
+    uint32_t terminal = std::countr_zero(reachedTerminals);
+
+    int bottleneck = INT_MAX;
+
+    for (uint32_t node = terminal; !((this->sourceMask >> node) & 1); node = parents[node]) bottleneck = std::min(bottleneck, this->residuals[parents[node]][node]);
+
+    for (uint32_t node = terminal; !((this->sourceMask >> node) & 1); node = parents[node]) {
+        this->setResidual(parents[node], node, this->residuals[parents[node]][node] - bottleneck);
+        this->setResidual(node, parents[node], this->residuals[node][parents[node]] + bottleneck);
+    }
+
+    return true;
+};
+
+template <uint32_t NodeCount>
+constexpr void FixedFlowNetwork<NodeCount>::maximizeFlow()
+{
+    while (this->augment());
+};
+
+template <uint32_t NodeCount>
+constexpr void FixedFlowNetwork<NodeCount>::resetFlow()
+{
+    this->residualMasks = {};
+
+    for (uint32_t start = 0; start < NodeCount; start++) {
+        for (uint32_t end = 0; end < NodeCount; end++) this->setResidual(start, end, this->capacities[start][end]);
+    }
+};
+
+#endif
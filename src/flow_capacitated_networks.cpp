@@ -2,26 +2,47 @@
 #include <stdexcept>
 #include <queue>
 #include <algorithm>
+#include <numeric>
 #include <vector>
 #include <filesystem>
 #include <fstream>
+#include <future>
 
 #include "flow_capacitated_networks.hpp"
+#include "augmenting_paths.hpp"
+#include "bipartite_matching.hpp"
+#include "unit_residual_bits.hpp"
+#include "node_interning.hpp"
+#include "parallel_chunks.hpp"
 
-size_t std::hash<Edge>::operator()(const Edge& edge) const
+uint64_t mixHash(uint64_t value)
 {
-    size_t startHash = std::hash<std::string>()(edge.start);
-    size_t endHash = std::hash<std::string>()(edge.end);
+    value += 0x9e3779b97f4a7c15;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
 
-    return startHash ^ endHash ^ edge.capacity;
+    return value ^ (value >> 31);
 };
 
-size_t std::hash<std::pair<std::string, std::string>>::operator()(const std::pair<std::string, std::string>& edge) const
+// start and end are mixed in different positions so an edge and its reversal hash differently
+uint64_t edgeKey(const std::string& start, const std::string& end)
+{
+    return mixHash(mixHash(std::hash<std::string>()(start)) + std::hash<std::string>()(end));
+};
+
+uint64_t edgeFingerprint(const std::string& start, const std::string& end, int capacity)
+{
+    return mixHash(edgeKey(start, end) ^ static_cast<uint32_t>(capacity));
+};
+
+size_t std::hash<Edge>::operator()(const Edge& edge) const
 {
-    size_t startHash = std::hash<std::string>()(edge.first);
-    size_t endHash = std::hash<std::string>()(edge.second);
+    return edgeFingerprint(edge.start, edge.end, edge.capacity);
+};
 
-    return startHash ^ endHash;
+size_t std::hash<std::pair<std::string, std::string>>::operator()(const std::pair<std::string, std::string>& edge) const
+{
+    return edgeKey(edge.first, edge.second);
 };
 
 int getMaxCapacity(std::unordered_map<std::string, int> vertexCapacity)
@@ -47,65 +68,88 @@ int getMaxCapacity(std::unordered_map<std::string, int> vertexCapacity, std::uno
     return std::max(getMaxCapacity(vertexCapacity), getMaxCapacity(edges));
 };
 
-int getTotalCapacity(std::unordered_map<std::string, int> vertexCapacity)
+FlowCapacitatedNetwork::FlowCapacitatedNetwork(std::unordered_set<std::string> nodes, std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals, std::unordered_set<Edge> edges)
 {
-    int totalCapacity = 0;
+    this->sources = sources;
+    this->terminals = terminals;
 
-    for (const auto& [_, capacity] : vertexCapacity) totalCapacity += capacity;
+    for (const auto& node : nodes) {
+        this->nodeIndices[node] = this->nodes.size();
+        this->nodes.push_back(node);
+    }
 
-    return totalCapacity;
-};
+    for (const auto& source : sources) this->sourceIndices.push_back(this->nodeIndices[source]);
 
-int getTotalCapacity(std::unordered_set<Edge> edges)
-{
-    int totalCapacity = 0;
+    this->terminalMask.assign(this->nodes.size(), false);
+
+    for (const auto& terminal : terminals) {
+        this->terminalIndices.push_back(this->nodeIndices[terminal]);
+        this->terminalMask[this->nodeIndices[terminal]] = true;
+    }
 
-    for (const auto& edge : edges) totalCapacity += edge.capacity;
+    std::unordered_map<std::pair<std::string, std::string>, int> edgeCapacities;
 
-    return totalCapacity;
+    for (const auto& edge : edges) edgeCapacities[{ edge.start, edge.end }] = edge.capacity;
+
+    std::vector<IndexedEdge> indexedEdges;
+    indexedEdges.reserve(edgeCapacities.size());
+
+    for (const auto& [endpoints, capacity] : edgeCapacities) indexedEdges.emplace_back(this->nodeIndices[endpoints.first], this->nodeIndices[endpoints.second], capacity);
+
+    this->arcs = ResidualArcs(this->nodes.size(), indexedEdges);
+
+    this->vertexSplit = false;
+
+    // the fingerprint is a sum of per node and per edge terms, so it ignores order and updates in place
+    this->fingerprint = 0;
+
+    for (const auto& node : this->nodes) this->fingerprint += mixHash(std::hash<std::string>()(node));
+
+    for (const auto& [endpoints, capacity] : edgeCapacities) this->fingerprint += edgeFingerprint(endpoints.first, endpoints.second, capacity);
 };
 
-int getTotalCapacity(std::unordered_map<std::string, int> vertexCapacity, std::unordered_set<Edge> edges)
+FlowCapacitatedNetwork FlowCapacitatedNetwork::fromEdgeCapacitated(std::unordered_set<std::string> nodes, std::string source, std::string terminal, std::unordered_set<Edge> edges)
 {
-    return getTotalCapacity(vertexCapacity) + getTotalCapacity(edges);
+    return fromMultiBoundaryEdgeCapacitated(nodes, { source }, { terminal }, edges);
 };
 
-FlowCapacitatedNetwork::FlowCapacitatedNetwork(std::unordered_set<std::string> nodes, std::string source, std::string terminal, std::unordered_set<Edge> edges)
+FlowCapacitatedNetwork FlowCapacitatedNetwork::fromVertexCapacitated(std::unordered_set<std::string> nodes, std::string source, std::string terminal, std::unordered_set<std::pair<std::string, std::string>> edges, std::unordered_map<std::string, int> vertexCapacity)
 {
-    this->nodes = nodes;
-    this->source = source;
-    this->terminal = terminal;
-    
-    for (const auto& edge : edges) {
-        this->capacityMatrix[edge.start][edge.end] = edge.capacity;
-
-        this->flowMatrix[edge.start][edge.end] = 0;
+    return fromMultiBoundaryVertexCapacitated(nodes, { source }, { terminal }, edges, vertexCapacity);
+};
 
-        this->residualMatrix[edge.start][edge.end] = edge.capacity;
-        if (!this->residualMatrix[edge.end].contains(edge.start)) this->residualMatrix[edge.end][edge.start] = 0;
-    }
+FlowCapacitatedNetwork FlowCapacitatedNetwork::fromEdgeAndVertexCapacitated(std::unordered_set<std::string> nodes, std::string source, std::string terminal, std::unordered_set<Edge> edges, std::unordered_map<std::string, int> vertexCapacity)
+{
+    return fromMultiBoundaryEdgeAndVertexCapacitated(nodes, { source }, { terminal }, edges, vertexCapacity);
 };
 
-FlowCapacitatedNetwork FlowCapacitatedNetwork::fromEdgeCapacitated(std::unordered_set<std::string> nodes, std::string source, std::string terminal, std::unordered_set<Edge> edges)
+FlowCapacitatedNetwork FlowCapacitatedNetwork::fromMultiBoundaryEdgeCapacitated(std::unordered_set<std::string> nodes, std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals, std::unordered_set<Edge> edges)
 {
-    if (!nodes.contains(source)) throw std::runtime_error("FlowCapacitatedNetwork constructor: nodes does not contain source");
-    if (!nodes.contains(terminal)) throw std::runtime_error("FlowCapacitatedNetwork constructor: nodes does not contain terminal");
+    if (sources.empty()) throw std::runtime_error("FlowCapacitatedNetwork constructor: network must have a source");
+    if (terminals.empty()) throw std::runtime_error("FlowCapacitatedNetwork constructor: network must have a terminal");
+
+    for (const auto& source : sources) {
+        if (!nodes.contains(source)) throw std::runtime_error("FlowCapacitatedNetwork constructor: nodes does not contain source");
+        if (terminals.contains(source)) throw std::runtime_error("FlowCapacitatedNetwork constructor: node cannot be both a source and a terminal");
+    }
+
+    for (const auto& terminal : terminals) if (!nodes.contains(terminal)) throw std::runtime_error("FlowCapacitatedNetwork constructor: nodes does not contain terminal");
 
     for (const auto& node : nodes) if (node.empty()) throw std::runtime_error("FlowCapacitatedNetwork constructor: nodes must have a name");
 
     for (const auto& edge : edges) {
         if (!nodes.contains(edge.start) || !nodes.contains(edge.end)) throw std::runtime_error("FlowCapacitatedNetwork constructor: edge contains invalid node");
 
-        if (edge.end == source) throw std::runtime_error("FlowCapacitatedNetwork constructor: edge cannot end at source");
-        if (edge.start == terminal) throw std::runtime_error("FlowCapacitatedNetwork constructor: edge cannot start at terminal");
+        if (sources.contains(edge.end)) throw std::runtime_error("FlowCapacitatedNetwork constructor: edge cannot end at source");
+        if (terminals.contains(edge.start)) throw std::runtime_error("FlowCapacitatedNetwork constructor: edge cannot start at terminal");
         
         if (edge.capacity < 0) throw std::runtime_error("FlowCapacitatedNetwork constructor: edge capacity cannot be negative");
     }
 
-    return FlowCapacitatedNetwork(nodes, source, terminal, edges);
+    return FlowCapacitatedNetwork(nodes, sources, terminals, edges);
 };
 
-FlowCapacitatedNetwork FlowCapacitatedNetwork::fromVertexCapacitated(std::unordered_set<std::string> nodes, std::string source, std::string terminal, std::unordered_set<std::pair<std::string, std::string>> edges, std::unordered_map<std::string, int> vertexCapacity)
+FlowCapacitatedNetwork FlowCapacitatedNetwork::fromMultiBoundaryVertexCapacitated(std::unordered_set<std::string> nodes, std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals, std::unordered_set<std::pair<std::string, std::string>> edges, std::unordered_map<std::string, int> vertexCapacity)
 {
     int maxCapacity = getMaxCapacity(vertexCapacity);
 
@@ -113,16 +157,36 @@ FlowCapacitatedNetwork FlowCapacitatedNetwork::fromVertexCapacitated(std::unorde
 
     for (const auto& [start, end] : edges) edgesWithCapacities.emplace(start, end, maxCapacity);
 
-    return fromEdgeAndVertexCapacitated(nodes, source, terminal, edgesWithCapacities, vertexCapacity);
+    return fromMultiBoundaryEdgeAndVertexCapacitated(nodes, sources, terminals, edgesWithCapacities, vertexCapacity);
 };
 
-FlowCapacitatedNetwork FlowCapacitatedNetwork::fromEdgeAndVertexCapacitated(std::unordered_set<std::string> nodes, std::string source, std::string terminal, std::unordered_set<Edge> edges, std::unordered_map<std::string, int> vertexCapacity)
+FlowCapacitatedNetwork FlowCapacitatedNetwork::fromMultiBoundaryEdgeAndVertexCapacitated(std::unordered_set<std::string> nodes, std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals, std::unordered_set<Edge> edges, std::unordered_map<std::string, int> vertexCapacity)
 {
-    if (vertexCapacity.contains(source) || vertexCapacity.contains(terminal)) throw std::runtime_error("FlowCapacitatedNetwork constructor: source and terminal cannot have a capacity");
+    for (const auto& source : sources) {
+        if (!nodes.contains(source)) throw std::runtime_error("FlowCapacitatedNetwork constructor: nodes does not contain source");
+        if (terminals.contains(source)) throw std::runtime_error("FlowCapacitatedNetwork constructor: node cannot be both a source and a terminal");
+    }
 
+    for (const auto& terminal : terminals) if (!nodes.contains(terminal)) throw std::runtime_error("FlowCapacitatedNetwork constructor: nodes does not contain terminal");
+
+    // sources only need an out node and terminals only need an in node, so neither is split or capacitated
     std::unordered_set<std::string> splitNodes;
-    splitNodes.emplace(source + "-out");
-    splitNodes.emplace(terminal + "-in");
+    std::unordered_set<std::string> splitSources;
+    std::unordered_set<std::string> splitTerminals;
+
+    for (const auto& source : sources) {
+        if (vertexCapacity.contains(source)) throw std::runtime_error("FlowCapacitatedNetwork constructor: sources and terminals cannot have a capacity");
+
+        splitNodes.emplace(source + "-out");
+        splitSources.emplace(source + "-out");
+    }
+
+    for (const auto& terminal : terminals) {
+        if (vertexCapacity.contains(terminal)) throw std::runtime_error("FlowCapacitatedNetwork constructor: sources and terminals cannot have a capacity");
+
+        splitNodes.emplace(terminal + "-in");
+        splitTerminals.emplace(terminal + "-in");
+    }
 
     for (const auto& [node, capacity] : vertexCapacity) {
         if (!nodes.contains(node)) throw std::runtime_error("FlowCapacitatedNetwork constructor: vertex capacity contains invalid node");
@@ -135,7 +199,7 @@ FlowCapacitatedNetwork FlowCapacitatedNetwork::fromEdgeAndVertexCapacitated(std:
         splitNodes.emplace(node + "-out");
     }
 
-    if (vertexCapacity.size() != nodes.size() - 2) throw std::runtime_error("FlowCapacitatedNetwork constructor: every internal node must have an explicit capacity");
+    if (vertexCapacity.size() + sources.size() + terminals.size() != nodes.size()) throw std::runtime_error("FlowCapacitatedNetwork constructor: every internal node must have an explicit capacity");
 
     std::unordered_set<Edge> edgesWithCapacities;
 
@@ -146,201 +210,429 @@ FlowCapacitatedNetwork FlowCapacitatedNetwork::fromEdgeAndVertexCapacitated(std:
         edgesWithCapacities.emplace(node + "-out", node + "-in", capacity);
     }
 
-    return fromEdgeCapacitated(splitNodes, source + "-out", terminal + "-in", edgesWithCapacities);
+    FlowCapacitatedNetwork network = fromMultiBoundaryEdgeCapacitated(splitNodes, splitSources, splitTerminals, edgesWithCapacities);
+
+    network.vertexSplit = true;
+
+    return network;
 };
 
-FlowCapacitatedNetwork FlowCapacitatedNetwork::fromMultiBoundaryEdgeCapacitated(std::unordered_set<std::string> nodes, std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals, std::unordered_set<Edge> edges)
+FlowCapacitatedNetwork FlowCapacitatedNetwork::fromEdgeList(const std::vector<Edge>& edges, std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals, unsigned threadCount)
 {
-    for (const auto& node : nodes) if (node.contains("$")) throw std::runtime_error("FlowCapacitatesNetwork constructor: node name cannot have $");
+    if (sources.empty()) throw std::runtime_error("FlowCapacitatedNetwork constructor: network must have a source");
+    if (terminals.empty()) throw std::runtime_error("FlowCapacitatedNetwork constructor: network must have a terminal");
+
+    for (const auto& source : sources) if (terminals.contains(source)) throw std::runtime_error("FlowCapacitatedNetwork constructor: node cannot be both a source and a terminal");
+
+    threadCount = resolveThreadCount(threadCount);
+
+    std::vector<std::string> boundaryNodes(sources.begin(), sources.end());
+    boundaryNodes.insert(boundaryNodes.end(), terminals.begin(), terminals.end());
+
+    InternedEdgeList interned = internEdgeList(edges, boundaryNodes, threadCount);
+
+    uint32_t nodeCount = interned.nodes.size();
+
+    FlowCapacitatedNetwork network;
+    network.sources = sources;
+    network.terminals = terminals;
+    network.nodes.resize(nodeCount);
+
+    forEachChunk(nodeCount, threadCount, [&](size_t begin, size_t end, unsigned) {
+        for (size_t node = begin; node < end; node++) {
+            if (interned.nodes[node].empty()) throw std::runtime_error("FlowCapacitatedNetwork constructor: nodes must have a name");
+
+            network.nodes[node] = interned.nodes[node];
+        }
+    });
+
+    // a hash map cannot be filled from several threads, so the name index is built on one thread alongside the
+    // validation, arc build and fingerprint below, none of which read it
+    std::future<void> indexBuild = std::async(std::launch::async, [&]() {
+        network.nodeIndices.reserve(nodeCount);
+
+        for (uint32_t node = 0; node < nodeCount; node++) network.nodeIndices.emplace(network.nodes[node], node);
+    });
 
-    nodes.emplace("$S");
-    nodes.emplace("$T");
+    std::vector<bool> sourceMask(nodeCount, false);
+    network.terminalMask.assign(nodeCount, false);
 
-    int totalCapacity = getTotalCapacity(edges);
+    // boundaryNodes lists the sources first, then the terminals
+    network.sourceIndices.assign(interned.boundaryIndices.begin(), interned.boundaryIndices.begin() + sources.size());
+    network.terminalIndices.assign(interned.boundaryIndices.begin() + sources.size(), interned.boundaryIndices.end());
 
-    for (const auto& source : sources) edges.emplace("$S", source, totalCapacity);
-    for (const auto& terminal : terminals) edges.emplace(terminal, "$T", totalCapacity);
+    for (const auto& sourceIndex : network.sourceIndices) sourceMask[sourceIndex] = true;
+    for (const auto& terminalIndex : network.terminalIndices) network.terminalMask[terminalIndex] = true;
 
-    return fromEdgeCapacitated(nodes, "$S", "$T", edges);
+    forEachChunk(edges.size(), threadCount, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++) {
+            const IndexedEdge& edge = interned.edges[i];
+
+            if (sourceMask[edge.end]) throw std::runtime_error("FlowCapacitatedNetwork constructor: edge cannot end at source");
+            if (network.terminalMask[edge.start]) throw std::runtime_error("FlowCapacitatedNetwork constructor: edge cannot start at terminal");
+
+            if (edge.capacity < 0) throw std::runtime_error("FlowCapacitatedNetwork constructor: edge capacity cannot be negative");
+        }
+    });
+
+    network.arcs = ResidualArcs(nodeCount, interned.edges, threadCount);
+
+    // the fingerprint terms are summed per thread, the same total the sequential constructor reaches
+    std::vector<uint64_t> fingerprints(threadCount, 0);
+
+    forEachChunk(nodeCount, threadCount, [&](size_t begin, size_t end, unsigned chunk) {
+        std::vector<uint32_t> heads;
+
+        for (size_t node = begin; node < end; node++) {
+            fingerprints[chunk] += mixHash(std::hash<std::string>()(network.nodes[node]));
+
+            heads.clear();
+
+            for (uint32_t arc = network.arcs.offsets[node]; arc < network.arcs.offsets[node + 1]; arc++) {
+                if (!network.arcs.forward[arc]) continue;
+
+                heads.push_back(network.arcs.heads[arc]);
+                fingerprints[chunk] += edgeFingerprint(network.nodes[node], network.nodes[network.arcs.heads[arc]], network.arcs.capacities[arc]);
+            }
+
+            std::sort(heads.begin(), heads.end());
+
+            if (std::adjacent_find(heads.begin(), heads.end()) != heads.end()) throw std::runtime_error("FlowCapacitatedNetwork constructor: edge list cannot repeat an edge");
+        }
+    });
+
+    network.fingerprint = std::accumulate(fingerprints.begin(), fingerprints.end(), uint64_t(0));
+    network.vertexSplit = false;
+
+    indexBuild.get();
+
+    return network;
 };
 
-FlowCapacitatedNetwork FlowCapacitatedNetwork::fromMultiBoundaryVertexCapacitated(std::unordered_set<std::string> nodes, std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals, std::unordered_set<std::pair<std::string, std::string>> edges, std::unordered_map<std::string, int> vertexCapacity)
+int FlowCapacitatedNetwork::getFlow()
 {
-    for (const auto& node : nodes) if (node.contains("$")) throw std::runtime_error("FlowCapacitatesNetwork constructor: node name cannot have $");
+    int sum = 0;
 
-    nodes.emplace("$S");
-    nodes.emplace("$T");
+    for (const auto& [_, throughput] : this->getSourceThroughput()) sum += throughput;
 
-    int totalCapacity = getTotalCapacity(vertexCapacity);
+    return sum;
+};
 
-    for (const auto& source : sources) {
-        edges.emplace("$S", source);
-        vertexCapacity[source] = totalCapacity;
-    }
+std::unordered_map<std::string, int> FlowCapacitatedNetwork::getSourceThroughput()
+{
+    std::unordered_map<std::string, int> throughput;
 
-    for (const auto& terminal : terminals) {
-        edges.emplace(terminal, "$T");
-        vertexCapacity[terminal] = totalCapacity;
+    for (const auto& sourceIndex : this->sourceIndices) {
+        int sum = 0;
+
+        for (uint32_t arc = this->arcs.offsets[sourceIndex]; arc < this->arcs.offsets[sourceIndex + 1]; arc++) sum += this->arcs.flow(arc);
+
+        throughput[this->nodes[sourceIndex]] = sum;
     }
 
-    return fromVertexCapacitated(nodes, "$S", "$T", edges, vertexCapacity);
+    return throughput;
 };
 
-FlowCapacitatedNetwork FlowCapacitatedNetwork::fromMultiBoundaryEdgeAndVertexCapacitated(std::unordered_set<std::string> nodes, std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals, std::unordered_set<Edge> edges, std::unordered_map<std::string, int> vertexCapacity)
+std::unordered_map<std::string, int> FlowCapacitatedNetwork::getTerminalThroughput()
 {
-    for (const auto& node : nodes) if (node.contains("$")) throw std::runtime_error("FlowCapacitatesNetwork constructor: node name cannot have $");
+    std::unordered_map<std::string, int> throughput;
 
-    nodes.emplace("$S");
-    nodes.emplace("$T");
+    for (const auto& terminalIndex : this->terminalIndices) {
+        int sum = 0;
 
-    int totalCapacity = getTotalCapacity(vertexCapacity, edges);
+        // edges cannot start at a terminal, so every arc leaving it is the reverse of an incoming edge, whose residual is that edge's flow
+        for (uint32_t arc = this->arcs.offsets[terminalIndex]; arc < this->arcs.offsets[terminalIndex + 1]; arc++) sum += this->arcs.residual(arc);
 
-    for (const auto& source : sources) {
-        edges.emplace("$S", source, totalCapacity);
-        vertexCapacity[source] = totalCapacity;
+        throughput[this->nodes[terminalIndex]] = sum;
     }
 
-    for (const auto& terminal : terminals) {
-        edges.emplace(terminal, "$T", totalCapacity);
-        vertexCapacity[terminal] = totalCapacity;
+    return throughput;
+};
+
+std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> FlowCapacitatedNetwork::findMinCut()
+{
+    SolverWorkspace& workspace = workspaceFor(this->arcs);
+
+    if (this->arcs.hasResidualBits()) markUnitReachable(this->arcs, this->sourceIndices, workspace);
+    else markReachable(this->arcs, this->arcs.residuals.data(), this->sourceIndices, workspace);
+
+    std::unordered_set<std::string> reachableFromSource;
+    std::unordered_set<std::string> unreachableFromSource;
+
+    for (uint32_t node = 0; node < this->nodes.size(); node++) {
+        if (workspace.isVisited(node)) reachableFromSource.emplace(this->nodes[node]);
+        else unreachableFromSource.emplace(this->nodes[node]);
     }
 
-    return fromEdgeAndVertexCapacitated(nodes, "$S", "$T", edges, vertexCapacity);
+    return { reachableFromSource, unreachableFromSource };
 };
 
-int FlowCapacitatedNetwork::getFlow()
+bool FlowCapacitatedNetwork::isMaxFlow()
 {
-    int sum = 0;
+    SolverWorkspace& workspace = workspaceFor(this->arcs);
 
-    for (auto [_, flow] : this->flowMatrix[this->source]) sum += flow;
+    if (this->arcs.hasResidualBits()) markUnitReachable(this->arcs, this->sourceIndices, workspace);
+    else markReachable(this->arcs, this->arcs.residuals.data(), this->sourceIndices, workspace);
 
-    return sum;
+    for (const auto& terminalIndex : this->terminalIndices) if (workspace.isVisited(terminalIndex)) return false;
+
+    return true;
 };
 
-std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> FlowCapacitatedNetwork::findMinCut()
+void FlowCapacitatedNetwork::augment()
 {
-    std::unordered_set<std::string> reachableFromSource;
-    std::unordered_set<std::string> unreachableFromSource = this->nodes;
+    this->arcs.restoreReverses();
+    this->arcs.unpackResiduals();
+
+    if (!augmentShortestPath(this->arcs, this->arcs.residuals.data(), this->sourceIndices, this->terminalMask, workspaceFor(this->arcs))) throw std::runtime_error("FlowCapacitatedNetwork augment: network is already maximal");
+};
+
+void FlowCapacitatedNetwork::maximizeFlow()
+{
+    this->maximizeFlow(workspaceFor(this->arcs));
+};
+
+void FlowCapacitatedNetwork::maximizeFlow(SolverWorkspace& workspace)
+{
+    this->arcs.restoreReverses();
+
+    if (!workspace.fits(this->arcs.nodeCount(), this->arcs.maxDegree())) throw std::runtime_error("FlowCapacitatedNetwork maximizeFlow: workspace is too small for network");
 
-    std::queue<std::string> queue;
-    queue.push(this->source);
+    // assignment networks are solved as a matching, which leaves nothing for the augmenting loop below, and a
+    // network already holding residual bits is unit capacity, so the bit solver picks it up without unpacking
+    if (!this->arcs.hasResidualBits()) solveUnitBipartite(this->arcs, this->sourceIndices, this->terminalMask);
 
-    while (!queue.empty()) {
-        std::string currNode = queue.front();
-        queue.pop();
+    if (maximizeUnitFlow(this->arcs, this->sourceIndices, this->terminalMask, workspace)) return;
 
-        reachableFromSource.emplace(currNode);
-        unreachableFromSource.erase(currNode);
+    this->arcs.unpackResiduals();
+
+    while (augmentShortestPath(this->arcs, this->arcs.residuals.data(), this->sourceIndices, this->terminalMask, workspace));
+};
+
+SolveProgress FlowCapacitatedNetwork::maximizeFlowWithin(const SolveBudget& budget)
+{
+    this->arcs.restoreReverses();
+    this->arcs.unpackResiduals();
 
-        for (const auto& [neighbor, flow] : this->residualMatrix[currNode]) if (!reachableFromSource.contains(neighbor) && flow > 0) queue.push(neighbor);
+    SolverWorkspace& workspace = workspaceFor(this->arcs);
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    size_t augmentations = 0;
+
+    auto currentProgress = [&]() {
+        int flow = this->getFlow();
+        int64_t upperBound = flow + residualLayerCutBound(this->arcs, this->arcs.residuals.data(), this->sourceIndices, this->terminalMask, workspace);
+
+        return SolveProgress { flow, upperBound, augmentations, std::chrono::steady_clock::now() - startTime };
+    };
+
+    while (!budget.isExhausted(augmentations) && augmentShortestPath(this->arcs, this->arcs.residuals.data(), this->sourceIndices, this->terminalMask, workspace)) {
+        augmentations++;
+
+        if (budget.onProgress && budget.progressInterval > 0 && augmentations % budget.progressInterval == 0) budget.onProgress(currentProgress());
     }
 
-    return { reachableFromSource, unreachableFromSource };
+    SolveProgress progress = currentProgress();
+
+    if (budget.onProgress) budget.onProgress(progress);
+
+    return progress;
 };
 
-bool FlowCapacitatedNetwork::isMaxFlow()
+uint64_t FlowCapacitatedNetwork::getFingerprint()
 {
-    return this->findMinCut().first.contains(this->terminal);
+    return this->fingerprint;
 };
 
-void FlowCapacitatedNetwork::augment()
+uint64_t FlowCapacitatedNetwork::getBoundaryFingerprint()
 {
-    std::unordered_map<std::string, std::string> parentTable;
-    parentTable[this->source] = "";
-    
-    std::queue<std::string> queue;
-    queue.push(this->source);
+    uint64_t boundaryFingerprint = 0;
 
-    std::string currNode;
+    for (const auto& source : this->sources) boundaryFingerprint += mixHash(std::hash<std::string>()(source));
+    for (const auto& terminal : this->terminals) boundaryFingerprint += mixHash(~std::hash<std::string>()(terminal));
 
-    while (!queue.empty()) {
-        currNode = queue.front();
-        queue.pop();
-        
-        for (const auto& [neighbor, flow] : this->residualMatrix[currNode]) if (!parentTable.contains(neighbor) && flow > 0) {
-            parentTable[neighbor] = currNode;
-            queue.push(neighbor);
+    return boundaryFingerprint;
+};
+
+std::vector<uint32_t> FlowCapacitatedNetwork::getCanonicalEdgeArcs() const
+{
+    std::vector<std::pair<uint64_t, uint32_t>> keyedArcs;
+
+    for (uint32_t start = 0; start < this->nodes.size(); start++) {
+        for (uint32_t arc = this->arcs.offsets[start]; arc < this->arcs.offsets[start + 1]; arc++) {
+            if (this->arcs.forward[arc]) keyedArcs.emplace_back(edgeKey(this->nodes[start], this->nodes[this->arcs.heads[arc]]), arc);
         }
     }
 
-    if (!parentTable.contains(this->terminal)) throw std::runtime_error("FlowCapacitatedNetwork augment: network is already maximal");
+    std::sort(keyedArcs.begin(), keyedArcs.end());
 
-    int bottleneck = this->residualMatrix[parentTable[this->terminal]][this->terminal];
+    std::vector<uint32_t> canonicalArcs;
+    canonicalArcs.reserve(keyedArcs.size());
 
-    currNode = this->terminal;
+    for (const auto& [_, arc] : keyedArcs) canonicalArcs.push_back(arc);
 
-    while (!parentTable[currNode].empty()) {
-        std::string parent = parentTable[currNode];
+    return canonicalArcs;
+};
+
+std::vector<int> FlowCapacitatedNetwork::getFlowAssignment()
+{
+    std::vector<int> flows;
 
-        if (this->residualMatrix[parent][currNode] < bottleneck) bottleneck = this->residualMatrix[parent][currNode];
+    for (const auto& arc : this->getCanonicalEdgeArcs()) flows.push_back(this->arcs.flow(arc));
+
+    return flows;
+};
 
-        currNode = parent;
+void FlowCapacitatedNetwork::setFlowAssignment(const std::vector<int>& flows)
+{
+    std::vector<uint32_t> canonicalArcs = this->getCanonicalEdgeArcs();
+
+    if (flows.size() != canonicalArcs.size()) throw std::runtime_error("FlowCapacitatedNetwork setFlowAssignment: flow assignment does not match network edges");
+
+    for (size_t i = 0; i < flows.size(); i++) {
+        if (flows[i] < 0 || flows[i] > this->arcs.capacities[canonicalArcs[i]]) throw std::runtime_error("FlowCapacitatedNetwork setFlowAssignment: flow must be within edge capacity");
     }
 
-    currNode = this->terminal;
+    this->arcs.restoreReverses();
+    this->arcs.unpackResiduals();
 
-    while (!parentTable[currNode].empty()) {
-        std::string parent = parentTable[currNode];
+    for (size_t i = 0; i < flows.size(); i++) {
+        uint32_t arc = canonicalArcs[i];
 
-        this->residualMatrix[parent][currNode] -= bottleneck;
-        this->residualMatrix[currNode][parent] += bottleneck;
+        this->arcs.residuals[arc] = this->arcs.capacities[arc] - flows[i];
+        this->arcs.residuals[this->arcs.reverses[arc]] = flows[i];
+    }
+};
 
-        if (this->flowMatrix[parent].contains(currNode)) this->flowMatrix[parent][currNode] += bottleneck;
-        else this->flowMatrix[currNode][parent] -= bottleneck;
+void FlowCapacitatedNetwork::resetFlow()
+{
+    this->arcs.resetFlow();
+};
+
+const ResidualArcs& FlowCapacitatedNetwork::getResidualArcs() const
+{
+    return this->arcs;
+};
+
+const std::vector<std::string>& FlowCapacitatedNetwork::getNodes() const
+{
+    return this->nodes;
+};
 
-        currNode = parent;
+const std::vector<uint32_t>& FlowCapacitatedNetwork::getSourceIndices() const
+{
+    return this->sourceIndices;
+};
+
+const std::vector<uint32_t>& FlowCapacitatedNetwork::getTerminalIndices() const
+{
+    return this->terminalIndices;
+};
+
+const std::vector<bool>& FlowCapacitatedNetwork::getTerminalMask() const
+{
+    return this->terminalMask;
+};
+
+bool FlowCapacitatedNetwork::isVertexSplit() const
+{
+    return this->vertexSplit;
+};
+
+std::string FlowCapacitatedNetwork::getOriginalNode(uint32_t node) const
+{
+    const std::string& name = this->nodes[node];
+
+    if (!this->vertexSplit) return name;
+
+    return name.substr(0, name.rfind('-'));
+};
+
+uint32_t FlowCapacitatedNetwork::getNodeIndex(std::string node) const
+{
+    auto found = this->nodeIndices.find(node);
+
+    if (found == this->nodeIndices.end()) throw std::runtime_error("FlowCapacitatedNetwork getNodeIndex: nodes does not contain " + node);
+
+    return found->second;
+};
+
+uint32_t FlowCapacitatedNetwork::findEdgeArc(std::string start, std::string end) const
+{
+    if (!this->nodeIndices.contains(start) || !this->nodeIndices.contains(end)) throw std::runtime_error("FlowCapacitatedNetwork findEdgeArc: edge contains invalid node");
+
+    uint32_t startIndex = this->nodeIndices.at(start);
+    uint32_t endIndex = this->nodeIndices.at(end);
+
+    for (uint32_t arc = this->arcs.offsets[startIndex]; arc < this->arcs.offsets[startIndex + 1]; arc++) {
+        if (this->arcs.forward[arc] && this->arcs.heads[arc] == endIndex) return arc;
     }
+
+    throw std::runtime_error("FlowCapacitatedNetwork findEdgeArc: edge does not exist");
 };
 
-void FlowCapacitatedNetwork::maximizeFlow()
+void FlowCapacitatedNetwork::setCapacity(std::string start, std::string end, int capacity)
 {
-    while (true) {
-        std::unordered_map<std::string, std::string> parentTable;
-        parentTable[this->source] = "";
-        
-        std::queue<std::string> queue;
-        queue.push(this->source);
+    if (capacity < 0) throw std::runtime_error("FlowCapacitatedNetwork setCapacity: edge capacity cannot be negative");
 
-        std::string currNode;
+    uint32_t arc = this->findEdgeArc(start, end);
 
-        while (!queue.empty()) {
-            currNode = queue.front();
-            queue.pop();
-            
-            for (const auto& [neighbor, flow] : this->residualMatrix[currNode]) if (!parentTable.contains(neighbor) && flow > 0) {
-                parentTable[neighbor] = currNode;
-                queue.push(neighbor);
-            }
-        }
+    this->arcs.unpackResiduals();
 
-        if (!parentTable.contains(this->terminal)) break;
+    int flow = this->arcs.flow(arc);
 
-        int bottleneck = this->residualMatrix[parentTable[this->terminal]][this->terminal];
+    this->fingerprint -= edgeFingerprint(start, end, this->arcs.capacities[arc]);
+    this->fingerprint += edgeFingerprint(start, end, capacity);
 
-        currNode = this->terminal;
+    this->arcs.capacities[arc] = capacity;
 
-        while (!parentTable[currNode].empty()) {
-            std::string parent = parentTable[currNode];
+    // the current flow stays as a warm start unless it no longer fits under the new capacity
+    if (flow <= capacity) this->arcs.residuals[arc] = capacity - flow;
+    else this->resetFlow();
+};
 
-            if (this->residualMatrix[parent][currNode] < bottleneck) bottleneck = this->residualMatrix[parent][currNode];
+void FlowCapacitatedNetwork::setBoundary(std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals)
+{
+    if (sources.empty()) throw std::runtime_error("FlowCapacitatedNetwork setBoundary: network must have a source");
+    if (terminals.empty()) throw std::runtime_error("FlowCapacitatedNetwork setBoundary: network must have a terminal");
 
-            currNode = parent;
-        }
+    for (const auto& source : sources) {
+        if (!this->nodeIndices.contains(source)) throw std::runtime_error("FlowCapacitatedNetwork setBoundary: nodes does not contain source");
+        if (terminals.contains(source)) throw std::runtime_error("FlowCapacitatedNetwork setBoundary: node cannot be both a source and a terminal");
 
-        currNode = this->terminal;
+        uint32_t sourceIndex = this->nodeIndices[source];
 
-        while (!parentTable[currNode].empty()) {
-            std::string parent = parentTable[currNode];
+        for (uint32_t arc = this->arcs.offsets[sourceIndex]; arc < this->arcs.offsets[sourceIndex + 1]; arc++) {
+            if (!this->arcs.forward[arc]) throw std::runtime_error("FlowCapacitatedNetwork setBoundary: edge cannot end at source");
+        }
+    }
 
-            this->residualMatrix[parent][currNode] -= bottleneck;
-            this->residualMatrix[currNode][parent] += bottleneck;
+    for (const auto& terminal : terminals) {
+        if (!this->nodeIndices.contains(terminal)) throw std::runtime_error("FlowCapacitatedNetwork setBoundary: nodes does not contain terminal");
 
-            if (this->flowMatrix[parent].contains(currNode)) this->flowMatrix[parent][currNode] += bottleneck;
-            else this->flowMatrix[currNode][parent] -= bottleneck;
+        uint32_t terminalIndex = this->nodeIndices[terminal];
 
-            currNode = parent;
+        for (uint32_t arc = this->arcs.offsets[terminalIndex]; arc < this->arcs.offsets[terminalIndex + 1]; arc++) {
+            if (this->arcs.forward[arc]) throw std::runtime_error("FlowCapacitatedNetwork setBoundary: edge cannot start at terminal");
         }
     }
+
+    this->sources = sources;
+    this->terminals = terminals;
+
+    this->sourceIndices.clear();
+    this->terminalIndices.clear();
+    this->terminalMask.assign(this->nodes.size(), false);
+
+    for (const auto& source : sources) this->sourceIndices.push_back(this->nodeIndices[source]);
+
+    for (const auto& terminal : terminals) {
+        this->terminalIndices.push_back(this->nodeIndices[terminal]);
+        this->terminalMask[this->nodeIndices[terminal]] = true;
+    }
+
+    this->resetFlow();
 };
 
 bool alphanumLess(const std::string& a, const std::string& b) {
@@ -370,6 +662,59 @@ void alphanumSort(std::vector<std::string>& v) {
     std::sort(v.begin(), v.end(), alphanumLess);
 }
 
+std::string concatStrList(std::vector<std::string> strList, std::string delimiter)
+{
+    std::string concat;
+
+    for (auto str : strList) concat += str + delimiter;
+
+    if (!strList.empty()) concat = concat.substr(0, concat.size() - delimiter.size());
+
+    return concat;
+};
+
+MemoryUsage FlowCapacitatedNetwork::memoryUsage() const
+{
+    MemoryUsage usage;
+
+    usage.nodes = vectorBytes(this->nodes) + mapBytes(this->nodeIndices) + setBytes(this->sources) + setBytes(this->terminals);
+    usage.nodes += vectorBytes(this->sourceIndices) + vectorBytes(this->terminalIndices) + vectorBytes(this->terminalMask);
+
+    usage.arcs = vectorBytes(this->arcs.offsets) + vectorBytes(this->arcs.heads) + vectorBytes(this->arcs.capacities) + vectorBytes(this->arcs.forward);
+    usage.flowState = vectorBytes(this->arcs.residuals) + vectorBytes(this->arcs.residualBits);
+    usage.caches = vectorBytes(this->arcs.reverses);
+    usage.scratch = SolverWorkspace::getThreadBytes(this->arcs.nodeCount(), this->arcs.maxDegree());
+
+    return usage;
+};
+
+void FlowCapacitatedNetwork::shrinkToFit()
+{
+    this->nodes.shrink_to_fit();
+    this->nodeIndices.rehash(0);
+    this->sources.rehash(0);
+    this->terminals.rehash(0);
+    this->sourceIndices.shrink_to_fit();
+    this->terminalIndices.shrink_to_fit();
+    this->terminalMask.shrink_to_fit();
+
+    this->arcs.shrinkToFit();
+};
+
+void FlowCapacitatedNetwork::compact(bool dropReverseArcs)
+{
+    if (dropReverseArcs) this->arcs.dropReverses();
+
+    this->shrinkToFit();
+
+    SolverWorkspace::releaseThreadWorkspace(this->arcs.nodeCount(), this->arcs.maxDegree());
+};
+
+void FlowCapacitatedNetwork::restoreReverseArcs()
+{
+    this->arcs.restoreReverses();
+};
+
 std::string FlowCapacitatedNetwork::toString()
 {
     std::string output;
@@ -389,15 +734,23 @@ std::string FlowCapacitatedNetwork::toString()
 
     output += "\n";
 
-    output += "Source: " + this->source + "\n";
-    output += "Terminal: " + this->terminal + "\n";
+    std::vector<std::string> sortedSources(this->sources.begin(), this->sources.end());
+    std::vector<std::string> sortedTerminals(this->terminals.begin(), this->terminals.end());
+
+    alphanumSort(sortedSources);
+    alphanumSort(sortedTerminals);
+
+    output += (sortedSources.size() == 1 ? "Source: " : "Sources: ") + concatStrList(sortedSources, ", ") + "\n";
+    output += (sortedTerminals.size() == 1 ? "Terminal: " : "Terminals: ") + concatStrList(sortedTerminals, ", ") + "\n";
 
     output += "Capacity Matrix:\n";
 
     std::vector<std::string> sortedCapacityMatrix;
 
-    for (const auto& [start, neighbors] : this->capacityMatrix) {
-        for (const auto& [end, capacity] : neighbors) sortedCapacityMatrix.emplace_back("\tC(" + start + ", " + end + ") = " + std::to_string(capacity) + "\n");
+    for (uint32_t start = 0; start < this->nodes.size(); start++) {
+        for (uint32_t arc = this->arcs.offsets[start]; arc < this->arcs.offsets[start + 1]; arc++) {
+            if (this->arcs.forward[arc]) sortedCapacityMatrix.emplace_back("\tC(" + this->nodes[start] + ", " + this->nodes[this->arcs.heads[arc]] + ") = " + std::to_string(this->arcs.capacities[arc]) + "\n");
+        }
     }
 
     alphanumSort(sortedCapacityMatrix);
@@ -408,8 +761,10 @@ std::string FlowCapacitatedNetwork::toString()
     
     // std::vector<std::string> sortedFlowMatrix;
 
-    // for (const auto& [start, neighbors] : this->flowMatrix) {
-    //     for (const auto& [end, capacity] : neighbors) sortedFlowMatrix.emplace_back("\t F(" + start + ", " + end + ") = " + std::to_string(capacity) + "\n");
+    // for (uint32_t start = 0; start < this->nodes.size(); start++) {
+    //     for (uint32_t arc = this->arcs.offsets[start]; arc < this->arcs.offsets[start + 1]; arc++) {
+    //         if (this->arcs.forward[arc]) sortedFlowMatrix.emplace_back("\t F(" + this->nodes[start] + ", " + this->nodes[this->arcs.heads[arc]] + ") = " + std::to_string(this->arcs.flow(arc)) + "\n");
+    //     }
     // }
 
     // alphanumSort(sortedFlowMatrix);
@@ -420,8 +775,10 @@ std::string FlowCapacitatedNetwork::toString()
     
     // std::vector<std::string> sortedResidualMatrix;
 
-    // for (const auto& [start, neighbors] : this->residualMatrix) {
-    //     for (const auto& [end, capacity] : neighbors) sortedResidualMatrix.emplace_back("\t R(" + start + ", " + end + ") = " + std::to_string(capacity) + "\n");
+    // for (uint32_t start = 0; start < this->nodes.size(); start++) {
+    //     for (uint32_t arc = this->arcs.offsets[start]; arc < this->arcs.offsets[start + 1]; arc++) {
+    //         sortedResidualMatrix.emplace_back("\t R(" + this->nodes[start] + ", " + this->nodes[this->arcs.heads[arc]] + ") = " + std::to_string(this->arcs.residuals[arc]) + "\n");
+    //     }
     // }
 
     // alphanumSort(sortedResidualMatrix);
@@ -442,6 +799,35 @@ std::string concatStrSet(std::unordered_set<std::string> strSet, std::string del
     return concat;
 };
 
+std::string FlowCapacitatedNetwork::nodeDeclsToDOT()
+{
+    std::string output;
+
+    std::string sourceRanks;
+    std::string terminalRanks;
+
+    for (const auto& source : this->sources) {
+        output += "\t\"" + source + "\" [shape=circle, style=filled, fillcolor=lightblue, penwidth=3, fontsize=20];\n";
+        sourceRanks += " \"" + source + "\";";
+    }
+
+    for (const auto& terminal : this->terminals) {
+        output += "\t\"" + terminal + "\" [shape=circle, style=filled, fillcolor=lightcoral, penwidth=3, fontsize=20];\n";
+        terminalRanks += " \"" + terminal + "\";";
+    }
+
+    output += "\t{ rank=min;" + sourceRanks + " }\n";
+    output += "\t{ rank=max;" + terminalRanks + " }\n";
+
+    std::unordered_set<std::string> nodeDecls;
+    for (const auto& node : this->nodes) if (!this->sources.contains(node) && !this->terminals.contains(node)) nodeDecls.insert("\t\"" + node + "\" [shape=circle, fontsize=20];");
+
+    output += concatStrSet(nodeDecls, "\n");
+    output += "\n";
+
+    return output;
+};
+
 std::string FlowCapacitatedNetwork::capacityGraphToDOT()
 {
     std::string output;
@@ -456,22 +842,14 @@ std::string FlowCapacitatedNetwork::capacityGraphToDOT()
     output += "\tranksep=1.0;";
     output += "\n";
 
-    output += "\t\"" + source + "\" [shape=circle, style=filled, fillcolor=lightblue, penwidth=3, fontsize=20];\n";
-    output += "\t\"" + terminal + "\" [shape=circle, style=filled, fillcolor=lightcoral, penwidth=3, fontsize=20];\n";
-
-    output += "\t{ rank=min; \"" + source + "\"; }\n";
-    output += "\t{ rank=max; \"" + terminal + "\"; }\n";
-
-    std::unordered_set<std::string> nodeDecls;
-    for (const auto& node : nodes) if (node != source && node != terminal) nodeDecls.insert("\t\"" + node + "\" [shape=circle, fontsize=20];");
-
-    output += concatStrSet(nodeDecls, "\n");
-    output += "\n";
+    output += this->nodeDeclsToDOT();
 
     std::unordered_set<std::string> edgeDotSet;
-    for (const auto& [start, edges] : this->capacityMatrix) {
-        for (auto& [end, capacity] : edges) {
-            if (capacity > 0) edgeDotSet.insert("\t\"" + start + "\" -> \"" + end + "\" [label=\"" + std::to_string(capacity) + "\", fontsize=20];");
+    for (uint32_t start = 0; start < this->nodes.size(); start++) {
+        for (uint32_t arc = this->arcs.offsets[start]; arc < this->arcs.offsets[start + 1]; arc++) {
+            int capacity = this->arcs.capacities[arc];
+
+            if (this->arcs.forward[arc] && capacity > 0) edgeDotSet.insert("\t\"" + this->nodes[start] + "\" -> \"" + this->nodes[this->arcs.heads[arc]] + "\" [label=\"" + std::to_string(capacity) + "\", fontsize=20];");
         }
     }
     output += concatStrSet(edgeDotSet, "\n");
@@ -496,22 +874,14 @@ std::string FlowCapacitatedNetwork::flowGraphToDOT()
     output += "\tranksep=1.0;";
     output += "\n";
 
-    output += "\t\"" + source + "\" [shape=circle, style=filled, fillcolor=lightblue, penwidth=3, fontsize=20];\n";
-    output += "\t\"" + terminal + "\" [shape=circle, style=filled, fillcolor=lightcoral, penwidth=3, fontsize=20];\n";
-
-    output += "\t{ rank=min; \"" + source + "\"; }\n";
-    output += "\t{ rank=max; \"" + terminal + "\"; }\n";
-
-    std::unordered_set<std::string> nodeDecls;
-    for (const auto& node : nodes) if (node != source && node != terminal) nodeDecls.insert("\t\"" + node + "\" [shape=circle, fontsize=20];");
-
-    output += concatStrSet(nodeDecls, "\n");
-    output += "\n";
+    output += this->nodeDeclsToDOT();
 
     std::unordered_set<std::string> edgeDotSet;
-    for (const auto& [start, edges] : this->capacityMatrix) {
-        for (auto& [end, capacity] : edges) {
-            if (capacity > 0) edgeDotSet.insert("\t\"" + start + "\" -> \"" + end + "\" [label=\"" + std::to_string(this->flowMatrix[start][end]) + "/" + std::to_string(capacity) + "\", fontsize=20];");
+    for (uint32_t start = 0; start < this->nodes.size(); start++) {
+        for (uint32_t arc = this->arcs.offsets[start]; arc < this->arcs.offsets[start + 1]; arc++) {
+            int capacity = this->arcs.capacities[arc];
+
+            if (this->arcs.forward[arc] && capacity > 0) edgeDotSet.insert("\t\"" + this->nodes[start] + "\" -> \"" + this->nodes[this->arcs.heads[arc]] + "\" [label=\"" + std::to_string(this->arcs.flow(arc)) + "/" + std::to_string(capacity) + "\", fontsize=20];");
         }
     }
     output += concatStrSet(edgeDotSet, "\n");
@@ -536,22 +906,17 @@ std::string FlowCapacitatedNetwork::residualGraphToDOT()
     output += "\tranksep=1.0;";
     output += "\n";
 
-    output += "\t\"" + source + "\" [shape=circle, style=filled, fillcolor=lightblue, penwidth=3, fontsize=20];\n";
-    output += "\t\"" + terminal + "\" [shape=circle, style=filled, fillcolor=lightcoral, penwidth=3, fontsize=20];\n";
+    output += this->nodeDeclsToDOT();
 
-    output += "\t{ rank=min; \"" + source + "\"; }\n";
-    output += "\t{ rank=max; \"" + terminal + "\"; }\n";
-
-    std::unordered_set<std::string> nodeDecls;
-    for (const auto& node : nodes) if (node != source && node != terminal) nodeDecls.insert("\t\"" + node + "\" [shape=circle, fontsize=20];");
+    std::unordered_set<std::string> edgeDotSet;
+    for (uint32_t start = 0; start < this->nodes.size(); start++) {
+        // parallel arcs between the same pair of nodes are drawn as one residual edge
+        std::unordered_map<uint32_t, int> residualByEnd;
 
-    output += concatStrSet(nodeDecls, "\n");
-    output += "\n";
+        for (uint32_t arc = this->arcs.offsets[start]; arc < this->arcs.offsets[start + 1]; arc++) residualByEnd[this->arcs.heads[arc]] += this->arcs.residual(arc);
 
-    std::unordered_set<std::string> edgeDotSet;
-    for (const auto& [start, edges] : this->residualMatrix) {
-        for (auto& [end, flow] : edges) {
-            if (flow > 0) edgeDotSet.insert("\t\"" + start + "\" -> \"" + end + "\" [label=\"" + std::to_string(flow) + "\", fontsize=20];");
+        for (auto& [end, flow] : residualByEnd) {
+            if (flow > 0) edgeDotSet.insert("\t\"" + this->nodes[start] + "\" -> \"" + this->nodes[end] + "\" [label=\"" + std::to_string(flow) + "\", fontsize=20];");
         }
     }
     output += concatStrSet(edgeDotSet, "\n");
@@ -2,9 +2,15 @@
 #define FLOW_CAPACITATED_NETWORKS
 
 #include <string>
+#include <vector>
 #include <unordered_set>
 #include <unordered_map>
 
+#include "residual_arcs.hpp"
+#include "solver_workspace.hpp"
+#include "solve_budget.hpp"
+#include "memory_usage.hpp"
+
 class Edge
 {
     public:
@@ -30,17 +36,28 @@ struct std::hash<std::pair<std::string, std::string>> {
 class FlowCapacitatedNetwork
 {
     private:
-        std::unordered_set<std::string> nodes;
+        // nodes[i] is the name of node index i in arcs
+        std::vector<std::string> nodes;
+        std::unordered_map<std::string, uint32_t> nodeIndices;
+
+        std::unordered_set<std::string> sources;
+        std::unordered_set<std::string> terminals;
+
+        std::vector<uint32_t> sourceIndices;
+        std::vector<uint32_t> terminalIndices;
+        std::vector<bool> terminalMask;
+
+        ResidualArcs arcs;
+
+        uint64_t fingerprint;
 
-        std::string source;
-        std::string terminal;
+        // vertex capacitated networks name every node <original>-in or <original>-out
+        bool vertexSplit;
 
-        // matrix[start][end] = value of edge from start to end
-        std::unordered_map<std::string, std::unordered_map<std::string, int>> capacityMatrix;
-        std::unordered_map<std::string, std::unordered_map<std::string, int>> flowMatrix;
-        std::unordered_map<std::string, std::unordered_map<std::string, int>> residualMatrix;
+        FlowCapacitatedNetwork() = default;
+        FlowCapacitatedNetwork(std::unordered_set<std::string> nodes, std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals, std::unordered_set<Edge> edges);
 
-        FlowCapacitatedNetwork(std::unordered_set<std::string> nodes, std::string source, std::string terminal, std::unordered_set<Edge> edges);
+        std::string nodeDeclsToDOT();
 
     public:
         static FlowCapacitatedNetwork fromEdgeCapacitated(std::unordered_set<std::string> nodes, std::string source, std::string terminal, std::unordered_set<Edge> edges);
@@ -51,14 +68,62 @@ class FlowCapacitatedNetwork
         static FlowCapacitatedNetwork fromMultiBoundaryVertexCapacitated(std::unordered_set<std::string> nodes, std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals, std::unordered_set<std::pair<std::string, std::string>> edges, std::unordered_map<std::string, int> vertexCapacity);
         static FlowCapacitatedNetwork fromMultiBoundaryEdgeAndVertexCapacitated(std::unordered_set<std::string> nodes, std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals, std::unordered_set<Edge> edges, std::unordered_map<std::string, int> vertexCapacity);
 
+        // Bulk construction for large inputs: nodes are the edge endpoints plus the boundary, and interning, validation
+        // and the arc array build are spread over threadCount threads, 0 meaning every hardware thread.
+        // Unlike the set based factories, an edge list with two edges between the same pair of nodes is rejected.
+        static FlowCapacitatedNetwork fromEdgeList(const std::vector<Edge>& edges, std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals, unsigned threadCount = 0);
+
+        const ResidualArcs& getResidualArcs() const;
+        const std::vector<std::string>& getNodes() const;
+        const std::vector<uint32_t>& getSourceIndices() const;
+        const std::vector<uint32_t>& getTerminalIndices() const;
+        const std::vector<bool>& getTerminalMask() const;
+
+        bool isVertexSplit() const;
+        std::string getOriginalNode(uint32_t node) const;
+
+        uint32_t getNodeIndex(std::string node) const;
+        uint32_t findEdgeArc(std::string start, std::string end) const;
+
         int getFlow();
 
+        std::unordered_map<std::string, int> getSourceThroughput();
+        std::unordered_map<std::string, int> getTerminalThroughput();
+
         std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> findMinCut();
 
         bool isMaxFlow();
 
         void augment();
         void maximizeFlow();
+        void maximizeFlow(SolverWorkspace& workspace);
+
+        // augments until the budget runs out and reports the feasible flow reached with a cut bound on the optimum
+        SolveProgress maximizeFlowWithin(const SolveBudget& budget);
+
+        uint64_t getFingerprint();
+        uint64_t getBoundaryFingerprint();
+
+        // flow on every edge, ordered the same way for any two networks with the same fingerprint
+        std::vector<int> getFlowAssignment();
+        std::vector<uint32_t> getCanonicalEdgeArcs() const;
+        void setFlowAssignment(const std::vector<int>& flows);
+
+        void resetFlow();
+
+        void setCapacity(std::string start, std::string end, int capacity);
+        void setBoundary(std::unordered_set<std::string> sources, std::unordered_set<std::string> terminals);
+
+        MemoryUsage memoryUsage() const;
+
+        // releases spare container capacity
+        void shrinkToFit();
+
+        // also frees this thread's solver workspace for the network's size class, so references to it from
+        // SolverWorkspace::forThread must be fetched again, and with dropReverseArcs the reverse arc index, which is
+        // rebuilt by the next solve or by restoreReverseArcs() while flow and cut queries keep working without it
+        void compact(bool dropReverseArcs = false);
+        void restoreReverseArcs();
 
         std::string toString();
 
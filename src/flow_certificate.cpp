@@ -0,0 +1,111 @@
+#include <stdexcept>
+
+#include "flow_certificate.hpp"
+#include "parallel_chunks.hpp"
+
+bool CertificateReport::isFeasible() const
+{
+    return this->capacityViolations.empty() && this->conservationViolations.empty();
+};
+
+bool CertificateReport::isOptimal() const
+{
+    return this->isFeasible() && this->cutSeparates && this->flowValue == this->cutCapacity;
+};
+
+class ChunkReport
+{
+    public:
+        std::vector<std::pair<std::string, std::string>> capacityViolations;
+        std::vector<std::string> conservationViolations;
+
+        bool cutSeparates = true;
+
+        int64_t flowValue = 0;
+        int64_t cutCapacity = 0;
+};
+
+// flowOf(arc) is the flow of a forward arc, reverse arcs are read through the arc they reverse
+template <typename FlowOf>
+CertificateReport verifyArcFlows(const FlowCapacitatedNetwork& network, FlowOf flowOf, const std::unordered_set<std::string>& sourceSide, unsigned threadCount)
+{
+    const ResidualArcs& arcs = network.getResidualArcs();
+    const std::vector<std::string>& nodes = network.getNodes();
+    const std::vector<bool>& terminalMask = network.getTerminalMask();
+
+    if (!arcs.hasReverses()) throw std::runtime_error("verifyCertificate: network was compacted without its reverse arcs");
+
+    uint32_t nodeCount = arcs.nodeCount();
+
+    std::vector<bool> sideMask(nodeCount, false);
+    std::vector<bool> sourceMask(nodeCount, false);
+
+    for (const auto& node : sourceSide) sideMask[network.getNodeIndex(node)] = true;
+    for (const auto& sourceIndex : network.getSourceIndices()) sourceMask[sourceIndex] = true;
+
+    threadCount = resolveThreadCount(threadCount);
+
+    std::vector<ChunkReport> chunkReports(threadCount);
+
+    forEachChunk(nodeCount, threadCount, [&](size_t begin, size_t end, unsigned chunk) {
+        ChunkReport& report = chunkReports[chunk];
+
+        for (size_t node = begin; node < end; node++) {
+            int64_t outflow = 0;
+            int64_t inflow = 0;
+
+            for (uint32_t arc = arcs.offsets[node]; arc < arcs.offsets[node + 1]; arc++) {
+                if (!arcs.forward[arc]) {
+                    inflow += flowOf(arcs.reverses[arc]);
+                    continue;
+                }
+
+                int flow = flowOf(arc);
+
+                if (flow < 0 || flow > arcs.capacities[arc]) report.capacityViolations.emplace_back(nodes[node], nodes[arcs.heads[arc]]);
+
+                outflow += flow;
+
+                if (sideMask[node] && !sideMask[arcs.heads[arc]]) report.cutCapacity += arcs.capacities[arc];
+            }
+
+            if (sourceMask[node]) report.flowValue += outflow - inflow;
+            else if (!terminalMask[node] && inflow != outflow) report.conservationViolations.push_back(nodes[node]);
+
+            if (sideMask[node] != sourceMask[node] && (sourceMask[node] || terminalMask[node])) report.cutSeparates = false;
+        }
+    });
+
+    CertificateReport report { {}, {}, true, 0, 0 };
+
+    for (const auto& chunkReport : chunkReports) {
+        report.capacityViolations.insert(report.capacityViolations.end(), chunkReport.capacityViolations.begin(), chunkReport.capacityViolations.end());
+        report.conservationViolations.insert(report.conservationViolations.end(), chunkReport.conservationViolations.begin(), chunkReport.conservationViolations.end());
+
+        report.cutSeparates = report.cutSeparates && chunkReport.cutSeparates;
+        report.flowValue += chunkReport.flowValue;
+        report.cutCapacity += chunkReport.cutCapacity;
+    }
+
+    return report;
+};
+
+CertificateReport verifyCertificate(const FlowCapacitatedNetwork& network, const std::unordered_set<std::string>& sourceSide, unsigned threadCount)
+{
+    const ResidualArcs& arcs = network.getResidualArcs();
+
+    return verifyArcFlows(network, [&](uint32_t arc) { return arcs.flow(arc); }, sourceSide, threadCount);
+};
+
+CertificateReport verifyCertificate(const FlowCapacitatedNetwork& network, const std::vector<int>& flows, const std::unordered_set<std::string>& sourceSide, unsigned threadCount)
+{
+    std::vector<uint32_t> canonicalArcs = network.getCanonicalEdgeArcs();
+
+    if (flows.size() != canonicalArcs.size()) throw std::runtime_error("verifyCertificate: flow assignment does not match network edges");
+
+    std::vector<int> arcFlows(network.getResidualArcs().arcCount(), 0);
+
+    for (size_t i = 0; i < flows.size(); i++) arcFlows[canonicalArcs[i]] = flows[i];
+
+    return verifyArcFlows(network, [&](uint32_t arc) { return arcFlows[arc]; }, sourceSide, threadCount);
+};
@@ -0,0 +1,30 @@
+#ifndef FLOW_CERTIFICATE
+#define FLOW_CERTIFICATE
+
+#include "flow_capacitated_networks.hpp"
+
+// A flow and a cut certify each other: when the flow is feasible and its value equals the cut capacity, the flow is
+// maximum and the cut is minimum. Nodes are reported by their names in the network, so a split node shows up as
+// its -in or -out half.
+class CertificateReport
+{
+    public:
+        std::vector<std::pair<std::string, std::string>> capacityViolations;
+        std::vector<std::string> conservationViolations;
+
+        // false when the cut leaves out a source or takes in a terminal
+        bool cutSeparates;
+
+        int64_t flowValue;
+        int64_t cutCapacity;
+
+        bool isFeasible() const;
+        bool isOptimal() const;
+};
+
+// One pass over every node and arc split across threadCount threads, 0 meaning every hardware thread.
+// Checks the network's own flow, or a flow assignment ordered like getFlowAssignment(), against sourceSide.
+CertificateReport verifyCertificate(const FlowCapacitatedNetwork& network, const std::unordered_set<std::string>& sourceSide, unsigned threadCount = 0);
+CertificateReport verifyCertificate(const FlowCapacitatedNetwork& network, const std::vector<int>& flows, const std::unordered_set<std::string>& sourceSide, unsigned threadCount = 0);
+
+#endif
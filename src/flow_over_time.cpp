@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <climits>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+#include "flow_over_time.hpp"
+
+int TemporalPath::getDepartures(int horizon) const
+{
+    return std::max(horizon - this->transitTime, 0);
+};
+
+int FlowOverTime::getEdgeFlow(std::string start, std::string end, int time) const
+{
+    int flow = 0;
+
+    for (const auto& path : this->paths) {
+        int offset = 0;
+
+        for (size_t i = 0; i + 1 < path.nodes.size(); i++) {
+            int departure = time - offset;
+
+            offset += path.transitTimes[i];
+
+            if (path.nodes[i] != start || path.nodes[i + 1] != end) continue;
+
+            if (departure >= 0 && departure < path.getDepartures(this->horizon)) flow += path.rate;
+        }
+    }
+
+    return flow;
+};
+
+FlowOverTimeNetwork::FlowOverTimeNetwork(const FlowCapacitatedNetwork& network, const std::unordered_map<std::pair<std::string, std::string>, int>& transitTimes): nodes(network.getNodes()), sourceIndices(network.getSourceIndices()), terminalMask(network.getTerminalMask()), arcs(network.getResidualArcs()), transitTimes(network.getResidualArcs().arcCount(), 0)
+{
+    this->arcs.restoreReverses();
+    this->arcs.unpackResiduals();
+
+    for (const auto& [edge, transitTime] : transitTimes) {
+        if (transitTime < 0) throw std::runtime_error("FlowOverTimeNetwork: transit times cannot be negative");
+
+        uint32_t arc = network.findEdgeArc(edge.first, edge.second);
+
+        this->transitTimes[arc] = transitTime;
+        this->transitTimes[this->arcs.reverses[arc]] = -transitTime;
+    }
+
+    this->augmentations = this->augmentShortestPaths(std::numeric_limits<int64_t>::max());
+};
+
+// Successive shortest paths with transit times as costs, so each augmentation is no shorter than the one before.
+// Node potentials keep reduced costs non-negative for Dijkstra despite the negative reverse arcs, and a node the
+// sources cannot reach never becomes reachable again, so its stale potential is never read.
+std::vector<std::pair<int64_t, int>> FlowOverTimeNetwork::augmentShortestPaths(int64_t horizon)
+{
+    constexpr int64_t unreached = std::numeric_limits<int64_t>::max();
+    constexpr uint32_t noArc = UINT32_MAX;
+
+    uint32_t nodeCount = this->arcs.nodeCount();
+
+    this->arcs.resetFlow();
+
+    std::vector<std::pair<int64_t, int>> augmentations;
+
+    std::vector<int64_t> potentials(nodeCount, 0);
+    std::vector<int64_t> distances(nodeCount);
+    std::vector<uint32_t> parentArcs(nodeCount);
+
+    using QueueEntry = std::pair<int64_t, uint32_t>;
+
+    while (true) {
+        std::fill(distances.begin(), distances.end(), unreached);
+
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+
+        for (uint32_t source : this->sourceIndices) {
+            distances[source] = 0;
+            parentArcs[source] = noArc;
+            queue.emplace(0, source);
+        }
+
+        while (!queue.empty()) {
+            auto [distance, node] = queue.top();
+            queue.pop();
+
+            if (distance > distances[node]) continue;
+
+            for (uint32_t arc = this->arcs.offsets[node]; arc < this->arcs.offsets[node + 1]; arc++) {
+                if (this->arcs.residuals[arc] <= 0) continue;
+
+                uint32_t head = this->arcs.heads[arc];
+                int64_t headDistance = distance + this->transitTimes[arc] + potentials[node] - potentials[head];
+
+                if (headDistance < distances[head]) {
+                    distances[head] = headDistance;
+                    parentArcs[head] = arc;
+                    queue.emplace(headDistance, head);
+                }
+            }
+        }
+
+        // potentials become true transit times from the sources
+        uint32_t terminal = noArc;
+
+        for (uint32_t node = 0; node < nodeCount; node++) {
+            if (distances[node] == unreached) continue;
+
+            potentials[node] += distances[node];
+
+            if (this->terminalMask[node] && (terminal == noArc || potentials[node] < potentials[terminal])) terminal = node;
+        }
+
+        if (terminal == noArc || potentials[terminal] >= horizon) break;
+
+        int amount = INT_MAX;
+
+        for (uint32_t node = terminal; parentArcs[node] != noArc; node = this->arcs.heads[this->arcs.reverses[parentArcs[node]]]) {
+            amount = std::min(amount, this->arcs.residuals[parentArcs[node]]);
+        }
+
+        for (uint32_t node = terminal; parentArcs[node] != noArc; node = this->arcs.heads[this->arcs.reverses[parentArcs[node]]]) {
+            this->arcs.residuals[parentArcs[node]] -= amount;
+            this->arcs.residuals[this->arcs.reverses[parentArcs[node]]] += amount;
+        }
+
+        augmentations.emplace_back(potentials[terminal], amount);
+    }
+
+    return augmentations;
+};
+
+// Splits the static flow in arcs into source to terminal paths. Zero transit cycles a walk runs into are cancelled.
+std::vector<TemporalPath> FlowOverTimeNetwork::decomposeFlow()
+{
+    constexpr int32_t offPath = -1;
+
+    uint32_t nodeCount = this->arcs.nodeCount();
+
+    std::vector<int> remaining(this->arcs.arcCount(), 0);
+
+    for (uint32_t arc = 0; arc < this->arcs.arcCount(); arc++) {
+        if (this->arcs.forward[arc]) remaining[arc] = this->arcs.flow(arc);
+    }
+
+    // arcs before a node's cursor carry no remaining flow
+    std::vector<uint32_t> cursors(this->arcs.offsets.begin(), this->arcs.offsets.end() - 1);
+    std::vector<int32_t> positions(nodeCount, offPath);
+
+    auto nextArc = [&](uint32_t node) {
+        while (cursors[node] < this->arcs.offsets[node + 1] && remaining[cursors[node]] == 0) cursors[node]++;
+
+        return cursors[node] < this->arcs.offsets[node + 1] ? cursors[node] : UINT32_MAX;
+    };
+
+    std::vector<TemporalPath> paths;
+
+    for (uint32_t source : this->sourceIndices) {
+        while (nextArc(source) != UINT32_MAX) {
+            std::vector<uint32_t> walkNodes { source };
+            std::vector<uint32_t> walkArcs;
+
+            positions[source] = 0;
+
+            // flow is conserved, so every node the walk enters short of a terminal has an arc to leave by
+            while (!this->terminalMask[walkNodes.back()]) {
+                uint32_t arc = nextArc(walkNodes.back());
+                uint32_t head = this->arcs.heads[arc];
+
+                walkArcs.push_back(arc);
+
+                if (positions[head] == offPath) {
+                    positions[head] = walkNodes.size();
+                    walkNodes.push_back(head);
+                    continue;
+                }
+
+                size_t cycleStart = positions[head];
+                int amount = INT_MAX;
+
+                for (size_t i = cycleStart; i < walkArcs.size(); i++) amount = std::min(amount, remaining[walkArcs[i]]);
+                for (size_t i = cycleStart; i < walkArcs.size(); i++) remaining[walkArcs[i]] -= amount;
+
+                for (size_t i = cycleStart + 1; i < walkNodes.size(); i++) positions[walkNodes[i]] = offPath;
+
+                walkNodes.resize(cycleStart + 1);
+                walkArcs.resize(cycleStart);
+            }
+
+            TemporalPath path { {}, {}, 0, INT_MAX };
+
+            for (uint32_t arc : walkArcs) path.rate = std::min(path.rate, remaining[arc]);
+
+            for (uint32_t arc : walkArcs) {
+                remaining[arc] -= path.rate;
+
+                path.transitTimes.push_back(this->transitTimes[arc]);
+                path.transitTime += this->transitTimes[arc];
+            }
+
+            for (uint32_t node : walkNodes) {
+                path.nodes.push_back(this->nodes[node]);
+                positions[node] = offPath;
+            }
+
+            paths.push_back(path);
+        }
+    }
+
+    return paths;
+};
+
+int64_t FlowOverTimeNetwork::getMaxFlowValue(int horizon)
+{
+    if (horizon < 0) throw std::runtime_error("FlowOverTimeNetwork getMaxFlowValue: horizon cannot be negative");
+
+    int64_t value = 0;
+
+    for (const auto& [transitTime, amount] : this->augmentations) {
+        if (transitTime >= horizon) break;
+
+        value += amount * (horizon - transitTime);
+    }
+
+    return value;
+};
+
+FlowOverTime FlowOverTimeNetwork::maximizeFlowOverTime(int horizon)
+{
+    if (horizon < 0) throw std::runtime_error("FlowOverTimeNetwork maximizeFlowOverTime: horizon cannot be negative");
+
+    this->augmentShortestPaths(horizon);
+
+    FlowOverTime flowOverTime { horizon, 0, this->decomposeFlow() };
+
+    for (const auto& path : flowOverTime.paths) flowOverTime.value += static_cast<int64_t>(path.rate) * path.getDepartures(horizon);
+
+    return flowOverTime;
+};
+
+int FlowOverTimeNetwork::findQuickestHorizon(int64_t demand)
+{
+    if (demand <= 0) return 0;
+
+    if (this->augmentations.empty()) throw std::runtime_error("FlowOverTimeNetwork findQuickestHorizon: no terminal can be reached");
+
+    int64_t staticFlow = 0;
+
+    for (const auto& [_, amount] : this->augmentations) staticFlow += amount;
+
+    // past the longest augmentation every step delivers the whole static flow
+    int64_t upper = this->augmentations.back().first + (demand + staticFlow - 1) / staticFlow;
+
+    if (upper > INT_MAX) throw std::runtime_error("FlowOverTimeNetwork findQuickestHorizon: horizon overflows int");
+
+    int lower = 0;
+    int higher = upper;
+
+    while (lower < higher) {
+        int middle = lower + (higher - lower) / 2;
+
+        if (this->getMaxFlowValue(middle) >= demand) higher = middle;
+        else lower = middle + 1;
+    }
+
+    return lower;
+};
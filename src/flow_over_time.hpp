@@ -0,0 +1,68 @@
+#ifndef FLOW_OVER_TIME
+#define FLOW_OVER_TIME
+
+#include "flow_capacitated_networks.hpp"
+
+// Time is discrete: over a horizon of T steps, flow entering edge e at step t arrives at its end at step
+// t + transitTime(e), and everything must arrive by step T - 1. Edge capacities bound the flow entering per step.
+//
+// Nothing is expanded per step. A maximum flow over time is a temporally repeated static flow: every path of a
+// minimum transit time static flow is used at a constant rate for as many steps as still let it arrive in time.
+// Flow on the time expanded graph is generated from those paths on demand.
+
+class TemporalPath
+{
+    public:
+        std::vector<std::string> nodes;
+        // transit time of every edge along the path, and their sum
+        std::vector<int> transitTimes;
+        int transitTime;
+        int rate;
+
+        // the path is used at steps 0 .. departures - 1
+        int getDepartures(int horizon) const;
+};
+
+class FlowOverTime
+{
+    public:
+        int horizon;
+        int64_t value;
+        std::vector<TemporalPath> paths;
+
+        // flow entering edge (start, end) at step time
+        int getEdgeFlow(std::string start, std::string end, int time) const;
+};
+
+class FlowOverTimeNetwork
+{
+    private:
+        std::vector<std::string> nodes;
+        std::vector<uint32_t> sourceIndices;
+        std::vector<bool> terminalMask;
+
+        ResidualArcs arcs;
+
+        // transit time of every arc, negated on reverse arcs
+        std::vector<int> transitTimes;
+
+        // transit time and amount of every augmentation of an unbounded run, in order, which alone fixes the
+        // value of every horizon
+        std::vector<std::pair<int64_t, int>> augmentations;
+
+        // minimum transit time static flow from augmenting paths shorter than horizon, left in arcs
+        std::vector<std::pair<int64_t, int>> augmentShortestPaths(int64_t horizon);
+        std::vector<TemporalPath> decomposeFlow();
+
+    public:
+        // edges missing from transitTimes take no time to cross
+        FlowOverTimeNetwork(const FlowCapacitatedNetwork& network, const std::unordered_map<std::pair<std::string, std::string>, int>& transitTimes);
+
+        int64_t getMaxFlowValue(int horizon);
+        FlowOverTime maximizeFlowOverTime(int horizon);
+
+        // smallest horizon over which demand can reach the terminals
+        int findQuickestHorizon(int64_t demand);
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include <stdexcept>
+
+#include "flow_result_cache.hpp"
+
+size_t std::hash<FlowResultKey>::operator()(const FlowResultKey& key) const
+{
+    return key.fingerprint ^ (key.boundaryFingerprint * 0x9e3779b97f4a7c15);
+};
+
+FlowResultCache::FlowResultCache(size_t capacity)
+{
+    if (capacity == 0) throw std::runtime_error("FlowResultCache constructor: capacity must be positive");
+
+    this->capacity = capacity;
+    this->hits = 0;
+    this->misses = 0;
+};
+
+FlowResult& FlowResultCache::solve(FlowCapacitatedNetwork& network)
+{
+    FlowResultKey key { network.getFingerprint(), network.getBoundaryFingerprint() };
+
+    auto found = this->resultIndex.find(key);
+
+    if (found != this->resultIndex.end()) {
+        this->hits++;
+
+        this->results.splice(this->results.begin(), this->results, found->second);
+
+        network.setFlowAssignment(found->second->flows);
+
+        return *found->second;
+    }
+
+    this->misses++;
+
+    network.maximizeFlow();
+
+    this->results.push_front({ key, network.getFlowAssignment(), std::nullopt });
+    this->resultIndex[key] = this->results.begin();
+
+    if (this->results.size() > this->capacity) {
+        this->resultIndex.erase(this->results.back().key);
+        this->results.pop_back();
+    }
+
+    return this->results.front();
+};
+
+void FlowResultCache::maximizeFlow(FlowCapacitatedNetwork& network)
+{
+    this->solve(network);
+};
+
+std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> FlowResultCache::findMinCut(FlowCapacitatedNetwork& network)
+{
+    FlowResult& result = this->solve(network);
+
+    if (!result.minCut) result.minCut = network.findMinCut();
+
+    return *result.minCut;
+};
+
+size_t FlowResultCache::size()
+{
+    return this->results.size();
+};
+
+size_t FlowResultCache::getHits()
+{
+    return this->hits;
+};
+
+size_t FlowResultCache::getMisses()
+{
+    return this->misses;
+};
+
+void FlowResultCache::clear()
+{
+    this->results.clear();
+    this->resultIndex.clear();
+};
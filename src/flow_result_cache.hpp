@@ -0,0 +1,60 @@
+#ifndef FLOW_RESULT_CACHE
+#define FLOW_RESULT_CACHE
+
+#include <list>
+#include <optional>
+
+#include "flow_capacitated_networks.hpp"
+
+class FlowResultKey
+{
+    public:
+        uint64_t fingerprint;
+        uint64_t boundaryFingerprint;
+
+        bool operator==(const FlowResultKey&) const = default;
+};
+
+template <>
+struct std::hash<FlowResultKey> {
+    size_t operator()(const FlowResultKey& key) const;
+};
+
+class FlowResult
+{
+    public:
+        FlowResultKey key;
+
+        std::vector<int> flows;
+        std::optional<std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>>> minCut;
+};
+
+class FlowResultCache
+{
+    private:
+        size_t capacity;
+
+        // most recently used result first
+        std::list<FlowResult> results;
+        std::unordered_map<FlowResultKey, std::list<FlowResult>::iterator> resultIndex;
+
+        size_t hits;
+        size_t misses;
+
+        FlowResult& solve(FlowCapacitatedNetwork& network);
+
+    public:
+        FlowResultCache(size_t capacity);
+
+        void maximizeFlow(FlowCapacitatedNetwork& network);
+
+        std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> findMinCut(FlowCapacitatedNetwork& network);
+
+        size_t size();
+        size_t getHits();
+        size_t getMisses();
+
+        void clear();
+};
+
+#endif
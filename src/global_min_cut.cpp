@@ -0,0 +1,329 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <tuple>
+
+#include "global_min_cut.hpp"
+#include "parallel_chunks.hpp"
+
+class ContractionEdge
+{
+    public:
+        uint32_t start;
+        uint32_t end;
+        int64_t weight;
+};
+
+class ContractionGraph
+{
+    public:
+        uint32_t nodeCount;
+        std::vector<ContractionEdge> edges;
+};
+
+using WeightedSide = std::pair<int64_t, std::vector<bool>>;
+
+ContractionGraph undirectedGraph(const FlowCapacitatedNetwork& network)
+{
+    const ResidualArcs& arcs = network.getResidualArcs();
+
+    ContractionGraph graph { arcs.nodeCount(), {} };
+
+    for (uint32_t node = 0; node < arcs.nodeCount(); node++) {
+        for (uint32_t arc = arcs.offsets[node]; arc < arcs.offsets[node + 1]; arc++) {
+            if (arcs.forward[arc] && arcs.capacities[arc] > 0) graph.edges.push_back({ node, arcs.heads[arc], arcs.capacities[arc] });
+        }
+    }
+
+    return graph;
+};
+
+std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> namePartition(const FlowCapacitatedNetwork& network, std::vector<bool> side)
+{
+    if (!side[network.getSourceIndices()[0]]) side.flip();
+
+    std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> partition;
+
+    for (uint32_t node = 0; node < side.size(); node++) {
+        if (side[node]) partition.first.insert(network.getNodes()[node]);
+        else partition.second.insert(network.getNodes()[node]);
+    }
+
+    return partition;
+};
+
+uint32_t findRoot(std::vector<uint32_t>& parents, uint32_t node)
+{
+    while (parents[node] != node) node = parents[node] = parents[parents[node]];
+
+    return node;
+};
+
+// Maximum adjacency orderings: the last node of each phase is cut from everything else by its key, then merged into
+// the node before it. Keys live in a lazy max heap, stale entries are skipped when popped.
+WeightedSide stoerWagner(const ContractionGraph& graph)
+{
+    uint32_t nodeCount = graph.nodeCount;
+
+    std::vector<std::unordered_map<uint32_t, int64_t>> adjacency(nodeCount);
+
+    for (const auto& edge : graph.edges) {
+        if (edge.start == edge.end) continue;
+
+        adjacency[edge.start][edge.end] += edge.weight;
+        adjacency[edge.end][edge.start] += edge.weight;
+    }
+
+    std::vector<std::vector<uint32_t>> members(nodeCount);
+
+    for (uint32_t node = 0; node < nodeCount; node++) members[node] = { node };
+
+    std::vector<uint32_t> activeNodes(nodeCount);
+    std::iota(activeNodes.begin(), activeNodes.end(), 0);
+
+    std::vector<int64_t> keys(nodeCount);
+    std::vector<bool> added(nodeCount);
+
+    WeightedSide best { std::numeric_limits<int64_t>::max(), {} };
+
+    while (activeNodes.size() > 1) {
+        std::priority_queue<std::pair<int64_t, uint32_t>> queue;
+
+        for (uint32_t node : activeNodes) {
+            keys[node] = 0;
+            added[node] = false;
+            queue.emplace(0, node);
+        }
+
+        uint32_t previous = 0;
+        uint32_t last = 0;
+        int64_t lastKey = 0;
+
+        for (size_t addedCount = 0; addedCount < activeNodes.size();) {
+            auto [key, node] = queue.top();
+            queue.pop();
+
+            if (added[node] || key != keys[node]) continue;
+
+            added[node] = true;
+            addedCount++;
+
+            previous = last;
+            last = node;
+            lastKey = key;
+
+            for (const auto& [neighbour, weight] : adjacency[node]) {
+                if (added[neighbour]) continue;
+
+                keys[neighbour] += weight;
+                queue.emplace(keys[neighbour], neighbour);
+            }
+        }
+
+        if (lastKey < best.first) {
+            best.first = lastKey;
+            best.second.assign(nodeCount, false);
+
+            for (uint32_t member : members[last]) best.second[member] = true;
+        }
+
+        for (const auto& [neighbour, weight] : adjacency[last]) {
+            adjacency[neighbour].erase(last);
+
+            if (neighbour == previous) continue;
+
+            adjacency[previous][neighbour] += weight;
+            adjacency[neighbour][previous] += weight;
+        }
+
+        adjacency[last].clear();
+
+        members[previous].insert(members[previous].end(), members[last].begin(), members[last].end());
+
+        std::erase(activeNodes, last);
+    }
+
+    return best;
+};
+
+// Contracting edges in order of exponential keys with rate equal to their weight is the same as repeatedly
+// contracting an edge picked with probability proportional to its weight. components maps nodes into the result.
+ContractionGraph contractGraph(const ContractionGraph& graph, uint32_t targetCount, std::mt19937_64& random, std::vector<uint32_t>& components)
+{
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    std::vector<std::pair<double, uint32_t>> order;
+
+    for (uint32_t i = 0; i < graph.edges.size(); i++) order.emplace_back(-std::log1p(-uniform(random)) / graph.edges[i].weight, i);
+
+    std::sort(order.begin(), order.end());
+
+    std::vector<uint32_t> parents(graph.nodeCount);
+    std::iota(parents.begin(), parents.end(), 0);
+
+    uint32_t componentCount = graph.nodeCount;
+
+    for (const auto& [_, i] : order) {
+        if (componentCount <= targetCount) break;
+
+        uint32_t startRoot = findRoot(parents, graph.edges[i].start);
+        uint32_t endRoot = findRoot(parents, graph.edges[i].end);
+
+        if (startRoot == endRoot) continue;
+
+        parents[startRoot] = endRoot;
+        componentCount--;
+    }
+
+    ContractionGraph contracted { 0, {} };
+
+    std::vector<uint32_t> labels(graph.nodeCount, UINT32_MAX);
+    components.resize(graph.nodeCount);
+
+    for (uint32_t node = 0; node < graph.nodeCount; node++) {
+        uint32_t root = findRoot(parents, node);
+
+        if (labels[root] == UINT32_MAX) labels[root] = contracted.nodeCount++;
+
+        components[node] = labels[root];
+    }
+
+    for (const auto& edge : graph.edges) {
+        uint32_t start = components[edge.start];
+        uint32_t end = components[edge.end];
+
+        if (start != end) contracted.edges.push_back({ std::min(start, end), std::max(start, end), edge.weight });
+    }
+
+    // parallel edges are merged so deeper levels only pay for the contracted graph
+    std::sort(contracted.edges.begin(), contracted.edges.end(), [](const ContractionEdge& a, const ContractionEdge& b) {
+        return std::tie(a.start, a.end) < std::tie(b.start, b.end);
+    });
+
+    size_t mergedCount = 0;
+
+    for (const auto& edge : contracted.edges) {
+        if (mergedCount > 0 && contracted.edges[mergedCount - 1].start == edge.start && contracted.edges[mergedCount - 1].end == edge.end) contracted.edges[mergedCount - 1].weight += edge.weight;
+        else contracted.edges[mergedCount++] = edge;
+    }
+
+    contracted.edges.resize(mergedCount);
+
+    return contracted;
+};
+
+// the recursion has Theta(n^2) leaves, small enough to try every side of without allocating per side
+WeightedSide enumerateCuts(const ContractionGraph& graph)
+{
+    WeightedSide best { std::numeric_limits<int64_t>::max(), std::vector<bool>(graph.nodeCount) };
+    uint32_t bestMask = 1;
+
+    // node nodeCount - 1 stays on the far side so every cut is tried once
+    for (uint32_t mask = 1; mask < (1u << (graph.nodeCount - 1)); mask++) {
+        int64_t weight = 0;
+
+        for (const auto& edge : graph.edges) if (((mask >> edge.start) ^ (mask >> edge.end)) & 1) weight += edge.weight;
+
+        if (weight < best.first) {
+            best.first = weight;
+            bestMask = mask;
+        }
+    }
+
+    for (uint32_t node = 0; node < graph.nodeCount; node++) best.second[node] = (bestMask >> node) & 1;
+
+    return best;
+};
+
+WeightedSide kargerStein(const ContractionGraph& graph, std::mt19937_64& random)
+{
+    if (graph.nodeCount <= 6) return enumerateCuts(graph);
+
+    uint32_t targetCount = std::ceil(1 + graph.nodeCount / std::sqrt(2.0));
+
+    WeightedSide best { std::numeric_limits<int64_t>::max(), {} };
+
+    for (int branch = 0; branch < 2; branch++) {
+        std::vector<uint32_t> components;
+
+        ContractionGraph contracted = contractGraph(graph, targetCount, random, components);
+
+        auto [weight, contractedSide] = kargerStein(contracted, random);
+
+        if (weight >= best.first) continue;
+
+        best.first = weight;
+        best.second.resize(graph.nodeCount);
+
+        for (uint32_t node = 0; node < graph.nodeCount; node++) best.second[node] = contractedSide[components[node]];
+    }
+
+    return best;
+};
+
+std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> findGlobalMinCutStoerWagner(const FlowCapacitatedNetwork& network)
+{
+    return namePartition(network, stoerWagner(undirectedGraph(network)).second);
+};
+
+std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> findGlobalMinCutKargerStein(const FlowCapacitatedNetwork& network, unsigned threadCount, uint64_t seed)
+{
+    ContractionGraph graph = undirectedGraph(network);
+
+    // contraction never splits a connected component, so a disconnected network is answered by any one component
+    std::vector<uint32_t> parents(graph.nodeCount);
+    std::iota(parents.begin(), parents.end(), 0);
+
+    for (const auto& edge : graph.edges) parents[findRoot(parents, edge.start)] = findRoot(parents, edge.end);
+
+    std::vector<bool> side(graph.nodeCount);
+
+    for (uint32_t node = 0; node < graph.nodeCount; node++) side[node] = findRoot(parents, node) == findRoot(parents, 0);
+
+    if (std::find(side.begin(), side.end(), false) != side.end()) return namePartition(network, side);
+
+    // one trial finds the minimum with probability Omega(1 / log n)
+    uint32_t logNodes = std::ceil(std::log2(graph.nodeCount));
+    uint32_t trialCount = std::max(logNodes * logNodes, 1u);
+
+    std::vector<WeightedSide> trials(trialCount);
+
+    threadCount = std::min(resolveThreadCount(threadCount), trialCount);
+
+    forEachChunk(trialCount, threadCount, [&](size_t begin, size_t end, unsigned) {
+        for (size_t trial = begin; trial < end; trial++) {
+            // seed_seq keeps 32 bits of each value, so the seed goes in as two halves
+            std::seed_seq sequence { static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32), static_cast<uint32_t>(trial) };
+            std::mt19937_64 random(sequence);
+
+            trials[trial] = kargerStein(graph, random);
+        }
+    });
+
+    // the lowest trial wins ties, so the result does not depend on the thread count
+    auto best = std::min_element(trials.begin(), trials.end(), [](const WeightedSide& a, const WeightedSide& b) { return a.first < b.first; });
+
+    return namePartition(network, best->second);
+};
+
+int64_t getUndirectedCutCapacity(const FlowCapacitatedNetwork& network, const std::unordered_set<std::string>& side)
+{
+    const ResidualArcs& arcs = network.getResidualArcs();
+
+    std::vector<bool> sideMask(arcs.nodeCount(), false);
+
+    for (const auto& node : side) sideMask[network.getNodeIndex(node)] = true;
+
+    int64_t capacity = 0;
+
+    for (uint32_t node = 0; node < arcs.nodeCount(); node++) {
+        for (uint32_t arc = arcs.offsets[node]; arc < arcs.offsets[node + 1]; arc++) {
+            if (arcs.forward[arc] && sideMask[node] != sideMask[arcs.heads[arc]]) capacity += arcs.capacities[arc];
+        }
+    }
+
+    return capacity;
+};
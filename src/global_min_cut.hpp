@@ -0,0 +1,21 @@
+#ifndef GLOBAL_MIN_CUT
+#define GLOBAL_MIN_CUT
+
+#include "flow_capacitated_networks.hpp"
+
+// The weakest cut anywhere in the network, ignoring sources and terminals. Edge directions are ignored too, so the
+// capacity of a cut is the sum of the capacities of the edges crossing it either way.
+//
+// The partition has the same shape as findMinCut(), with the first set holding the network's first source.
+
+// deterministic, n - 1 phases each pushing once per edge relaxation onto a lazy binary heap, so O(nm log n) in
+// total, plus expected constant time hashing per relaxation and per merged edge of the hash map adjacency
+std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> findGlobalMinCutStoerWagner(const FlowCapacitatedNetwork& network);
+
+// Randomized recursive contraction repeated over O(log^2 n) independent trials, spread over threadCount threads with 0
+// meaning every hardware thread. A miss is polynomially unlikely in n, and the result depends only on the seed.
+std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> findGlobalMinCutKargerStein(const FlowCapacitatedNetwork& network, unsigned threadCount = 0, uint64_t seed = 0);
+
+int64_t getUndirectedCutCapacity(const FlowCapacitatedNetwork& network, const std::unordered_set<std::string>& side);
+
+#endif
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "line_server.hpp"
+
+void LineServer::Client::disconnect()
+{
+    close(this->fd);
+    this->fd = -1;
+};
+
+LineServer::LineServer(std::string socketPath): socketPath(socketPath)
+{
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+
+    if (socketPath.size() >= sizeof(address.sun_path)) throw std::runtime_error("LineServer constructor: socket path is too long");
+
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    // a client that disappears between poll and accept must not block the loop either
+    this->listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (this->listenFd < 0) throw std::runtime_error(std::string("LineServer constructor: socket: ") + std::strerror(errno));
+
+    unlink(socketPath.c_str());
+
+    mode_t previousMask = umask(0177);
+    int bound = bind(this->listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    umask(previousMask);
+
+    if (bound < 0 || listen(this->listenFd, SOMAXCONN) < 0) {
+        std::string error = std::strerror(errno);
+
+        close(this->listenFd);
+        throw std::runtime_error("LineServer constructor: " + socketPath + ": " + error);
+    }
+};
+
+LineServer::~LineServer()
+{
+    for (auto& client : this->clients) client.disconnect();
+
+    close(this->listenFd);
+    unlink(this->socketPath.c_str());
+};
+
+void LineServer::serveOnce(const LineHandler& answer, int timeoutMilliseconds)
+{
+    std::vector<pollfd> pollFds;
+    pollFds.push_back({ this->listenFd, POLLIN, 0 });
+
+    for (const auto& client : this->clients) pollFds.push_back({ client.fd, static_cast<short>(POLLIN | (client.pendingOutput.empty() ? 0 : POLLOUT)), 0 });
+
+    if (poll(pollFds.data(), pollFds.size(), timeoutMilliseconds) < 0) {
+        if (errno == EINTR) return;
+
+        throw std::runtime_error(std::string("LineServer serveOnce: poll: ") + std::strerror(errno));
+    }
+
+    // gather every complete line from every ready client first, then answer the whole batch
+    std::vector<std::pair<size_t, std::string>> batch;
+
+    for (size_t i = 0; i < this->clients.size(); i++) {
+        short events = pollFds[i + 1].revents;
+        Client& client = this->clients[i];
+
+        if (events & (POLLIN | POLLHUP | POLLERR)) {
+            char buffer[4096];
+
+            ssize_t readCount = read(client.fd, buffer, sizeof(buffer));
+
+            if (readCount == 0 || (readCount < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                client.disconnect();
+                continue;
+            }
+
+            if (readCount > 0) client.pendingInput.append(buffer, readCount);
+
+            for (size_t newline; (newline = client.pendingInput.find('\n')) != std::string::npos;) {
+                batch.emplace_back(i, client.pendingInput.substr(0, newline));
+                client.pendingInput.erase(0, newline + 1);
+            }
+
+            if (client.pendingInput.size() > maxPendingBytes) {
+                client.disconnect();
+                continue;
+            }
+        }
+
+        // the socket is non blocking, so this takes what fits in the kernel buffer and leaves the rest for later
+        if ((events & POLLOUT) && client.fd >= 0) {
+            ssize_t writeCount = send(client.fd, client.pendingOutput.data(), client.pendingOutput.size(), MSG_NOSIGNAL);
+
+            if (writeCount > 0) client.pendingOutput.erase(0, writeCount);
+            else if (writeCount < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) client.disconnect();
+        }
+    }
+
+    for (const auto& [clientIndex, line] : batch) {
+        Client& client = this->clients[clientIndex];
+
+        if (client.fd < 0) continue;
+
+        client.pendingOutput += answer(line) + "\n";
+
+        // replies the client never reads would otherwise pile up here
+        if (client.pendingOutput.size() > maxPendingBytes) client.disconnect();
+    }
+
+    std::erase_if(this->clients, [](const Client& client) { return client.fd < 0; });
+
+    if (pollFds[0].revents & POLLIN) {
+        int clientFd = accept4(this->listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (clientFd >= 0) this->clients.push_back({ clientFd, "", "" });
+    }
+};
+
+size_t LineServer::getClientCount() const
+{
+    return this->clients.size();
+};
@@ -0,0 +1,48 @@
+#ifndef LINE_SERVER
+#define LINE_SERVER
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Line based request and reply over a Unix domain socket, one poll loop for every client. Client sockets are non
+// blocking, so a client that stops reading its replies only stalls itself: its unsent replies wait in pendingOutput
+// while every other client keeps being served. The socket is created readable and writable by its owner only.
+class LineServer
+{
+    private:
+        class Client
+        {
+            public:
+                int fd;
+                std::string pendingInput;
+                std::string pendingOutput;
+
+                void disconnect();
+        };
+
+        std::string socketPath;
+        int listenFd;
+
+        std::vector<Client> clients;
+
+    public:
+        using LineHandler = std::function<std::string(std::string line)>;
+
+        // a client whose unfinished line or unread replies outgrow this is dropped
+        static constexpr size_t maxPendingBytes = 1 << 20;
+
+        LineServer(std::string socketPath);
+        ~LineServer();
+
+        LineServer(const LineServer&) = delete;
+        LineServer& operator=(const LineServer&) = delete;
+
+        // waits up to timeoutMilliseconds, -1 for no limit, then reads, answers and writes whatever is ready; lines
+        // that arrive together from every client are answered as one batch
+        void serveOnce(const LineHandler& answer, int timeoutMilliseconds = -1);
+
+        size_t getClientCount() const;
+};
+
+#endif
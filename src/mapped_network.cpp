@@ -0,0 +1,481 @@
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped_network.hpp"
+
+constexpr uint64_t mappedNetworkMagic = 0x4b524f5754454e46;
+
+class MappedNetworkHeader
+{
+    public:
+        uint64_t magic;
+        uint64_t nodeCount;
+        uint64_t arcCount;
+        uint64_t sourceCount;
+        uint64_t terminalCount;
+};
+
+// byte offsets of offsets, heads, reverses, capacities, forward, sources and terminals, then the file size, every
+// section starting on a cache line
+std::array<size_t, 8> mappedSections(const MappedNetworkHeader& header)
+{
+    std::array<size_t, 7> sectionBytes = {
+        (header.nodeCount + 1) * sizeof(uint32_t),
+        header.arcCount * sizeof(uint32_t),
+        header.arcCount * sizeof(uint32_t),
+        header.arcCount * sizeof(int),
+        header.arcCount * sizeof(uint8_t),
+        header.sourceCount * sizeof(uint32_t),
+        header.terminalCount * sizeof(uint32_t),
+    };
+
+    std::array<size_t, 8> sections;
+    sections[0] = 64;
+
+    for (size_t i = 0; i < sectionBytes.size(); i++) sections[i + 1] = (sections[i] + sectionBytes[i] + 63) / 64 * 64;
+
+    return sections;
+};
+
+std::runtime_error systemError(std::string context)
+{
+    return std::runtime_error(context + ": " + std::strerror(errno));
+};
+
+void MappedNetwork::write(std::string path, uint32_t nodeCount, const std::vector<uint32_t>& sources, const std::vector<uint32_t>& terminals, const EdgeStream& edges, const std::vector<uint32_t>& order)
+{
+    if (sources.empty()) throw std::runtime_error("MappedNetwork write: network must have a source");
+    if (terminals.empty()) throw std::runtime_error("MappedNetwork write: network must have a terminal");
+
+    if (!order.empty() && order.size() != nodeCount) throw std::runtime_error("MappedNetwork write: order must cover every node");
+
+    if (!order.empty()) {
+        std::vector<bool> taken(nodeCount, false);
+
+        for (uint32_t index : order) {
+            if (index >= nodeCount) throw std::runtime_error("MappedNetwork write: order contains invalid index");
+            if (taken[index]) throw std::runtime_error("MappedNetwork write: order cannot repeat an index");
+
+            taken[index] = true;
+        }
+    }
+
+    auto position = [&](uint32_t node) { return order.empty() ? node : order[node]; };
+
+    std::vector<bool> sourceMask(nodeCount, false);
+    std::vector<bool> terminalMask(nodeCount, false);
+
+    for (uint32_t source : sources) {
+        if (source >= nodeCount) throw std::runtime_error("MappedNetwork write: source is not a node");
+
+        sourceMask[source] = true;
+    }
+
+    for (uint32_t terminal : terminals) {
+        if (terminal >= nodeCount) throw std::runtime_error("MappedNetwork write: terminal is not a node");
+        if (sourceMask[terminal]) throw std::runtime_error("MappedNetwork write: node cannot be both a source and a terminal");
+
+        terminalMask[terminal] = true;
+    }
+
+    // degrees by file position, turned into placement cursors once the arc count is known
+    std::vector<uint32_t> cursors(nodeCount, 0);
+    uint64_t arcCount = 0;
+
+    edges([&](uint32_t start, uint32_t end, int capacity) {
+        if (start >= nodeCount || end >= nodeCount) throw std::runtime_error("MappedNetwork write: edge contains invalid node");
+        if (sourceMask[end]) throw std::runtime_error("MappedNetwork write: edge cannot end at source");
+        if (terminalMask[start]) throw std::runtime_error("MappedNetwork write: edge cannot start at terminal");
+        if (capacity < 0) throw std::runtime_error("MappedNetwork write: edge capacity cannot be negative");
+
+        cursors[position(start)]++;
+        cursors[position(end)]++;
+        arcCount += 2;
+    });
+
+    if (arcCount > UINT32_MAX) throw std::runtime_error("MappedNetwork write: too many edges for 32 bit arc indices");
+
+    MappedNetworkHeader header { mappedNetworkMagic, nodeCount, arcCount, sources.size(), terminals.size() };
+
+    std::array<size_t, 8> sections = mappedSections(header);
+
+    // the network is built in a temporary file next to path and renamed over it once it is on disk, so a failed
+    // write, or a crash part way through, leaves any previous file at path untouched, and a network that still maps
+    // that file, even when it is the one being rewritten, keeps reading it
+    std::string temporaryPath = path + ".XXXXXX";
+
+    int fd = mkstemp(temporaryPath.data());
+
+    if (fd < 0) throw systemError("MappedNetwork write: mkstemp " + temporaryPath);
+
+    void* mapping = MAP_FAILED;
+
+    try {
+        if (fchmod(fd, 0644) < 0) throw systemError("MappedNetwork write: fchmod " + temporaryPath);
+        if (ftruncate(fd, sections[7]) < 0) throw systemError("MappedNetwork write: ftruncate " + temporaryPath);
+
+        mapping = mmap(nullptr, sections[7], PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (mapping == MAP_FAILED) throw systemError("MappedNetwork write: mmap " + temporaryPath);
+
+        char* bytes = static_cast<char*>(mapping);
+
+        uint32_t* offsets = reinterpret_cast<uint32_t*>(bytes + sections[0]);
+        uint32_t* heads = reinterpret_cast<uint32_t*>(bytes + sections[1]);
+        uint32_t* reverses = reinterpret_cast<uint32_t*>(bytes + sections[2]);
+        int* capacities = reinterpret_cast<int*>(bytes + sections[3]);
+        uint8_t* forward = reinterpret_cast<uint8_t*>(bytes + sections[4]);
+        uint32_t* sourceSection = reinterpret_cast<uint32_t*>(bytes + sections[5]);
+        uint32_t* terminalSection = reinterpret_cast<uint32_t*>(bytes + sections[6]);
+
+        offsets[0] = 0;
+
+        for (uint32_t node = 0; node < nodeCount; node++) {
+            offsets[node + 1] = offsets[node] + cursors[node];
+            cursors[node] = offsets[node];
+        }
+
+        uint64_t placedCount = 0;
+
+        edges([&](uint32_t start, uint32_t end, int capacity) {
+            placedCount += 2;
+
+            if (placedCount > arcCount) throw std::runtime_error("MappedNetwork write: edges changed between passes");
+
+            start = position(start);
+            end = position(end);
+
+            uint32_t forwardArc = cursors[start]++;
+            uint32_t reverseArc = cursors[end]++;
+
+            heads[forwardArc] = end;
+            reverses[forwardArc] = reverseArc;
+            capacities[forwardArc] = capacity;
+            forward[forwardArc] = 1;
+
+            heads[reverseArc] = start;
+            reverses[reverseArc] = forwardArc;
+            capacities[reverseArc] = 0;
+            forward[reverseArc] = 0;
+        });
+
+        if (placedCount != arcCount) throw std::runtime_error("MappedNetwork write: edges changed between passes");
+
+        for (size_t i = 0; i < sources.size(); i++) sourceSection[i] = position(sources[i]);
+        for (size_t i = 0; i < terminals.size(); i++) terminalSection[i] = position(terminals[i]);
+
+        std::memcpy(bytes, &header, sizeof(header));
+
+        if (msync(mapping, sections[7], MS_SYNC) < 0) throw systemError("MappedNetwork write: msync " + temporaryPath);
+
+        int unmapped = munmap(mapping, sections[7]);
+        mapping = MAP_FAILED;
+
+        if (unmapped < 0) throw systemError("MappedNetwork write: munmap " + temporaryPath);
+        if (fsync(fd) < 0) throw systemError("MappedNetwork write: fsync " + temporaryPath);
+
+        int closed = close(fd);
+        fd = -1;
+
+        if (closed < 0) throw systemError("MappedNetwork write: close " + temporaryPath);
+        if (rename(temporaryPath.c_str(), path.c_str()) < 0) throw systemError("MappedNetwork write: rename " + temporaryPath + " to " + path);
+    }
+    catch (...) {
+        if (mapping != MAP_FAILED) munmap(mapping, sections[7]);
+        if (fd >= 0) close(fd);
+
+        unlink(temporaryPath.c_str());
+        throw;
+    }
+};
+
+void MappedNetwork::write(std::string path, const FlowCapacitatedNetwork& network, const std::vector<uint32_t>& order)
+{
+    const ResidualArcs& arcs = network.getResidualArcs();
+
+    MappedNetwork::write(path, arcs.nodeCount(), network.getSourceIndices(), network.getTerminalIndices(), [&](const EdgeVisitor& visit) {
+        for (uint32_t node = 0; node < arcs.nodeCount(); node++) {
+            for (uint32_t arc = arcs.offsets[node]; arc < arcs.offsets[node + 1]; arc++) {
+                if (arcs.forward[arc]) visit(node, arcs.heads[arc], arcs.capacities[arc]);
+            }
+        }
+    }, order);
+};
+
+MappedNetwork::MappedNetwork(std::string path)
+{
+    this->fd = open(path.c_str(), O_RDONLY);
+
+    if (this->fd < 0) throw systemError("MappedNetwork constructor: open " + path);
+
+    struct stat status;
+
+    if (fstat(this->fd, &status) < 0) {
+        close(this->fd);
+        throw systemError("MappedNetwork constructor: fstat " + path);
+    }
+
+    MappedNetworkHeader header {};
+
+    if (static_cast<size_t>(status.st_size) < sizeof(header) || pread(this->fd, &header, sizeof(header), 0) != sizeof(header) || header.magic != mappedNetworkMagic || header.nodeCount > UINT32_MAX || header.arcCount > UINT32_MAX) {
+        close(this->fd);
+        throw std::runtime_error("MappedNetwork constructor: " + path + " is not a mapped network");
+    }
+
+    std::array<size_t, 8> sections = mappedSections(header);
+
+    if (static_cast<size_t>(status.st_size) != sections[7]) {
+        close(this->fd);
+        throw std::runtime_error("MappedNetwork constructor: " + path + " is truncated");
+    }
+
+    this->mappingBytes = sections[7];
+    this->mapping = mmap(nullptr, this->mappingBytes, PROT_READ, MAP_SHARED, this->fd, 0);
+
+    if (this->mapping == MAP_FAILED) {
+        close(this->fd);
+        throw systemError("MappedNetwork constructor: mmap " + path);
+    }
+
+    const char* bytes = static_cast<const char*>(this->mapping);
+
+    this->nodes = header.nodeCount;
+    this->arcs = header.arcCount;
+
+    this->offsets = reinterpret_cast<const uint32_t*>(bytes + sections[0]);
+    this->heads = reinterpret_cast<const uint32_t*>(bytes + sections[1]);
+    this->reverses = reinterpret_cast<const uint32_t*>(bytes + sections[2]);
+    this->capacities = reinterpret_cast<const int*>(bytes + sections[3]);
+    this->forward = reinterpret_cast<const uint8_t*>(bytes + sections[4]);
+
+    const uint32_t* sourceSection = reinterpret_cast<const uint32_t*>(bytes + sections[5]);
+    const uint32_t* terminalSection = reinterpret_cast<const uint32_t*>(bytes + sections[6]);
+
+    this->sourceIndices.assign(sourceSection, sourceSection + header.sourceCount);
+    this->terminalIndices.assign(terminalSection, terminalSection + header.terminalCount);
+
+    // every later search indexes node and arc arrays with these, so a damaged file has to fail here, checked while
+    // the residuals are filled since that already reads every arc in order
+    bool indicesValid = this->offsets[0] == 0 && this->offsets[this->nodes] == this->arcs;
+
+    for (uint32_t node : this->sourceIndices) indicesValid &= node < this->nodes;
+    for (uint32_t node : this->terminalIndices) indicesValid &= node < this->nodes;
+
+    this->residuals.resize(this->arcs);
+
+    for (uint32_t node = 0; indicesValid && node < this->nodes; node++) {
+        indicesValid &= this->offsets[node] <= this->offsets[node + 1] && this->offsets[node + 1] <= this->arcs;
+
+        for (uint32_t arc = this->offsets[node]; indicesValid && arc < this->offsets[node + 1]; arc++) {
+            indicesValid &= this->heads[arc] < this->nodes && this->reverses[arc] < this->arcs;
+
+            // a reverse arc has no capacity, so a zero flow leaves residuals equal to capacities
+            this->residuals[arc] = this->capacities[arc];
+        }
+    }
+
+    if (!indicesValid) {
+        munmap(this->mapping, this->mappingBytes);
+        close(this->fd);
+        throw std::runtime_error("MappedNetwork constructor: " + path + " has indices out of range");
+    }
+
+    this->terminalMask.assign(this->nodes, false);
+
+    for (uint32_t terminal : this->terminalIndices) this->terminalMask[terminal] = true;
+};
+
+MappedNetwork::~MappedNetwork()
+{
+    munmap(this->mapping, this->mappingBytes);
+    close(this->fd);
+};
+
+uint32_t MappedNetwork::nodeCount() const
+{
+    return this->nodes;
+};
+
+uint32_t MappedNetwork::arcCount() const
+{
+    return this->arcs;
+};
+
+// breadth first levels over positive residuals, -1 for nodes the sources cannot reach
+std::vector<int> MappedNetwork::breadthFirstLevels() const
+{
+    std::vector<int> levels(this->nodes, -1);
+    std::vector<uint32_t> queue;
+
+    for (uint32_t source : this->sourceIndices) {
+        levels[source] = 0;
+        queue.push_back(source);
+    }
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        uint32_t node = queue[head];
+
+        for (uint32_t arc = this->offsets[node]; arc < this->offsets[node + 1]; arc++) {
+            uint32_t next = this->heads[arc];
+
+            if (this->residuals[arc] > 0 && levels[next] < 0) {
+                levels[next] = levels[node] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+
+    return levels;
+};
+
+std::vector<uint32_t> MappedNetwork::breadthFirstOrder() const
+{
+    std::vector<uint32_t> order(this->nodes, UINT32_MAX);
+    std::vector<uint32_t> queue;
+
+    for (uint32_t source : this->sourceIndices) {
+        order[source] = queue.size();
+        queue.push_back(source);
+    }
+
+    // every arc counts here, residual or not, so the order only depends on the topology
+    for (size_t head = 0; head < queue.size(); head++) {
+        uint32_t node = queue[head];
+
+        for (uint32_t arc = this->offsets[node]; arc < this->offsets[node + 1]; arc++) {
+            uint32_t next = this->heads[arc];
+
+            if (order[next] == UINT32_MAX) {
+                order[next] = queue.size();
+                queue.push_back(next);
+            }
+        }
+    }
+
+    uint32_t position = queue.size();
+
+    for (uint32_t node = 0; node < this->nodes; node++) if (order[node] == UINT32_MAX) order[node] = position++;
+
+    return order;
+};
+
+void MappedNetwork::writeReordered(std::string path, const std::vector<uint32_t>& order) const
+{
+    MappedNetwork::write(path, this->nodes, this->sourceIndices, this->terminalIndices, [&](const EdgeVisitor& visit) {
+        for (uint32_t node = 0; node < this->nodes; node++) {
+            for (uint32_t arc = this->offsets[node]; arc < this->offsets[node + 1]; arc++) {
+                if (this->forward[arc]) visit(node, this->heads[arc], this->capacities[arc]);
+            }
+        }
+    }, order);
+};
+
+int64_t MappedNetwork::getFlow() const
+{
+    int64_t flow = 0;
+
+    // edges cannot end at a source, so every arc at a source is one of its outgoing edges
+    for (uint32_t source : this->sourceIndices) {
+        for (uint32_t arc = this->offsets[source]; arc < this->offsets[source + 1]; arc++) flow += this->capacities[arc] - this->residuals[arc];
+    }
+
+    return flow;
+};
+
+// Dinic's blocking flows. The search advances along arcs into the next level from each node's current arc, retreats
+// past nodes with no way forward, and restarts from the source after every augmentation.
+void MappedNetwork::maximizeFlow()
+{
+    std::vector<uint32_t> currentArcs(this->nodes);
+    std::vector<uint32_t> path;
+
+    while (true) {
+        std::vector<int> levels = this->breadthFirstLevels();
+
+        bool terminalReached = false;
+
+        for (uint32_t terminal : this->terminalIndices) terminalReached |= levels[terminal] >= 0;
+
+        if (!terminalReached) return;
+
+        std::copy(this->offsets, this->offsets + this->nodes, currentArcs.begin());
+
+        for (uint32_t source : this->sourceIndices) {
+            uint32_t node = source;
+            path.clear();
+
+            while (true) {
+                if (this->terminalMask[node]) {
+                    int amount = INT_MAX;
+
+                    for (uint32_t arc : path) amount = std::min(amount, this->residuals[arc]);
+
+                    for (uint32_t arc : path) {
+                        this->residuals[arc] -= amount;
+                        this->residuals[this->reverses[arc]] += amount;
+                    }
+
+                    node = source;
+                    path.clear();
+                    continue;
+                }
+
+                uint32_t& arc = currentArcs[node];
+
+                while (arc < this->offsets[node + 1] && (this->residuals[arc] <= 0 || levels[this->heads[arc]] != levels[node] + 1)) arc++;
+
+                if (arc < this->offsets[node + 1]) {
+                    path.push_back(arc);
+                    node = this->heads[arc];
+                    continue;
+                }
+
+                if (path.empty()) break;
+
+                // nothing more gets through this node in this phase
+                levels[node] = -1;
+
+                node = this->heads[this->reverses[path.back()]];
+                path.pop_back();
+                currentArcs[node]++;
+            }
+        }
+    }
+};
+
+void MappedNetwork::resetFlow()
+{
+    std::copy(this->capacities, this->capacities + this->arcs, this->residuals.begin());
+};
+
+std::vector<bool> MappedNetwork::findMinCut() const
+{
+    std::vector<int> levels = this->breadthFirstLevels();
+
+    std::vector<bool> sourceSide(this->nodes);
+
+    for (uint32_t node = 0; node < this->nodes; node++) sourceSide[node] = levels[node] >= 0;
+
+    return sourceSide;
+};
+
+size_t MappedNetwork::getResidentBytes() const
+{
+    return vectorBytes(this->residuals) + vectorBytes(this->sourceIndices) + vectorBytes(this->terminalIndices) + this->terminalMask.capacity() / 8;
+};
+
+size_t MappedNetwork::getMappedBytes() const
+{
+    return this->mappingBytes;
+};
@@ -0,0 +1,77 @@
+#ifndef MAPPED_NETWORK
+#define MAPPED_NETWORK
+
+#include <functional>
+
+#include "flow_capacitated_networks.hpp"
+
+// Out of core solving for networks whose topology does not fit in memory. The arc arrays and capacities live in a
+// memory mapped file the kernel pages in and out as needed, and only the residuals, one int per arc, and a few node
+// arrays stay resident. Nodes are indices, so a network written from a FlowCapacitatedNetwork keeps its numbering.
+//
+// Searches visit nodes in breadth first order, so a file whose nodes are numbered in that order, as
+// breadthFirstOrder() and writeReordered() produce, is read mostly front to back and faults pages in sequentially.
+
+class MappedNetwork
+{
+    private:
+        int fd;
+        void* mapping;
+        size_t mappingBytes;
+
+        uint32_t nodes;
+        uint32_t arcs;
+
+        // arcs leaving node v occupy [offsets[v], offsets[v + 1]), laid out like ResidualArcs
+        const uint32_t* offsets;
+        const uint32_t* heads;
+        const uint32_t* reverses;
+        const int* capacities;
+        const uint8_t* forward;
+
+        std::vector<uint32_t> sourceIndices;
+        std::vector<uint32_t> terminalIndices;
+        std::vector<bool> terminalMask;
+
+        std::vector<int> residuals;
+
+        std::vector<int> breadthFirstLevels() const;
+
+    public:
+        using EdgeVisitor = std::function<void(uint32_t start, uint32_t end, int capacity)>;
+        using EdgeStream = std::function<void(const EdgeVisitor& visit)>;
+
+        // Edges are streamed twice, once to count degrees and once to place arcs straight into the file, so only a
+        // degree per node is held in memory. order maps every node to a distinct index in the file, empty keeping
+        // the stream's numbering. Parallel edges are kept as parallel arcs. path is only replaced once the new file
+        // is complete, so a write that fails leaves whatever was there before, and may overwrite a mapped file.
+        static void write(std::string path, uint32_t nodeCount, const std::vector<uint32_t>& sources, const std::vector<uint32_t>& terminals, const EdgeStream& edges, const std::vector<uint32_t>& order = {});
+        static void write(std::string path, const FlowCapacitatedNetwork& network, const std::vector<uint32_t>& order = {});
+
+        MappedNetwork(std::string path);
+        ~MappedNetwork();
+
+        MappedNetwork(const MappedNetwork&) = delete;
+        MappedNetwork& operator=(const MappedNetwork&) = delete;
+
+        uint32_t nodeCount() const;
+        uint32_t arcCount() const;
+
+        // position of every node in a breadth first search from the sources, unreached nodes last
+        std::vector<uint32_t> breadthFirstOrder() const;
+        void writeReordered(std::string path, const std::vector<uint32_t>& order) const;
+
+        int64_t getFlow() const;
+
+        // blocking flows, with breadth first levels and one current arc per node as the only other resident state
+        void maximizeFlow();
+        void resetFlow();
+
+        // source side of the minimum cut
+        std::vector<bool> findMinCut() const;
+
+        size_t getResidentBytes() const;
+        size_t getMappedBytes() const;
+};
+
+#endif
@@ -0,0 +1,44 @@
+#include "memory_usage.hpp"
+
+size_t MemoryUsage::total() const
+{
+    return this->nodes + this->arcs + this->flowState + this->caches;
+};
+
+size_t stringBytes(const std::string& string)
+{
+    // strings that fit the small string buffer live inside the object
+    return sizeof(string) + (string.capacity() > std::string().capacity() ? string.capacity() + 1 : 0);
+};
+
+size_t vectorBytes(const std::vector<bool>& vector)
+{
+    return sizeof(vector) + (vector.capacity() + 7) / 8;
+};
+
+size_t vectorBytes(const std::vector<std::string>& vector)
+{
+    size_t bytes = sizeof(vector) + (vector.capacity() - vector.size()) * sizeof(std::string);
+
+    for (const auto& string : vector) bytes += stringBytes(string);
+
+    return bytes;
+};
+
+size_t setBytes(const std::unordered_set<std::string>& set)
+{
+    size_t bytes = sizeof(set) + set.bucket_count() * sizeof(void*);
+
+    for (const auto& element : set) bytes += sizeof(void*) + sizeof(size_t) + stringBytes(element);
+
+    return bytes;
+};
+
+size_t mapBytes(const std::unordered_map<std::string, uint32_t>& map)
+{
+    size_t bytes = sizeof(map) + map.bucket_count() * sizeof(void*);
+
+    for (const auto& [key, _] : map) bytes += sizeof(void*) + sizeof(size_t) + sizeof(std::pair<const std::string, uint32_t>) - sizeof(std::string) + stringBytes(key);
+
+    return bytes;
+};
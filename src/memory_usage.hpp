@@ -0,0 +1,49 @@
+#ifndef MEMORY_USAGE
+#define MEMORY_USAGE
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Byte counts are estimates of heap use plus the containers themselves: hash tables are charged one pointer per
+// bucket and a node of next pointer, cached hash and value per element, strings only past their inline buffer.
+class MemoryUsage
+{
+    public:
+        // names, the name index and the boundary
+        size_t nodes = 0;
+
+        // arc topology and capacities
+        size_t arcs = 0;
+
+        // residuals, the flow itself
+        size_t flowState = 0;
+
+        // derived data that can be dropped and rebuilt, such as the reverse arc index
+        size_t caches = 0;
+
+        // the calling thread's solver workspace for this network's size class, shared with every other network of
+        // that size class solved on the thread, so it is left out of total() and should be counted once per thread
+        size_t scratch = 0;
+
+        size_t total() const;
+};
+
+size_t stringBytes(const std::string& string);
+
+template <typename T, typename Allocator>
+size_t vectorBytes(const std::vector<T, Allocator>& vector)
+{
+    return sizeof(vector) + vector.capacity() * sizeof(T);
+};
+
+size_t vectorBytes(const std::vector<bool>& vector);
+size_t vectorBytes(const std::vector<std::string>& vector);
+
+size_t setBytes(const std::unordered_set<std::string>& set);
+size_t mapBytes(const std::unordered_map<std::string, uint32_t>& map);
+
+#endif
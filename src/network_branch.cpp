@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "network_branch.hpp"
+#include "augmenting_paths.hpp"
+
+NetworkBranch::NetworkBranch(std::shared_ptr<const FlowCapacitatedNetwork> root, std::shared_ptr<const BranchLayer> parent)
+{
+    this->root = root;
+    this->parent = parent;
+};
+
+NetworkBranch::NetworkBranch(std::shared_ptr<const FlowCapacitatedNetwork> root): NetworkBranch(root, nullptr)
+{
+    if (!root) throw std::runtime_error("NetworkBranch constructor: root network cannot be null");
+    if (!root->getResidualArcs().hasReverses()) throw std::runtime_error("NetworkBranch constructor: root network was compacted without its reverse arcs");
+};
+
+NetworkBranch NetworkBranch::branch()
+{
+    if (!this->capacityChanges.empty() || !this->flowChanges.empty()) {
+        auto layer = std::make_shared<BranchLayer>();
+
+        layer->parent = this->parent;
+        layer->capacities = std::move(this->capacityChanges);
+        layer->flows = std::move(this->flowChanges);
+
+        this->parent = layer;
+        this->capacityChanges.clear();
+        this->flowChanges.clear();
+    }
+
+    return NetworkBranch(this->root, this->parent);
+};
+
+int NetworkBranch::inheritedCapacity(uint32_t arc) const
+{
+    for (const BranchLayer* layer = this->parent.get(); layer; layer = layer->parent.get()) {
+        auto found = layer->capacities.find(arc);
+
+        if (found != layer->capacities.end()) return found->second;
+    }
+
+    return this->root->getResidualArcs().capacities[arc];
+};
+
+int NetworkBranch::inheritedFlow(uint32_t arc) const
+{
+    for (const BranchLayer* layer = this->parent.get(); layer; layer = layer->parent.get()) {
+        auto found = layer->flows.find(arc);
+
+        if (found != layer->flows.end()) return found->second;
+    }
+
+    return this->root->getResidualArcs().flow(arc);
+};
+
+int NetworkBranch::capacityOf(uint32_t arc) const
+{
+    auto found = this->capacityChanges.find(arc);
+
+    return found != this->capacityChanges.end() ? found->second : this->inheritedCapacity(arc);
+};
+
+int NetworkBranch::flowOf(uint32_t arc) const
+{
+    auto found = this->flowChanges.find(arc);
+
+    return found != this->flowChanges.end() ? found->second : this->inheritedFlow(arc);
+};
+
+std::vector<int> NetworkBranch::materializeResiduals(bool& warmStart) const
+{
+    const ResidualArcs& arcs = this->root->getResidualArcs();
+
+    std::vector<int> residuals(arcs.arcCount());
+
+    for (uint32_t arc = 0; arc < arcs.arcCount(); arc++) residuals[arc] = arcs.residual(arc);
+
+    // the nearest change to each arc wins, so each change is looked at once however deep the layers go
+    std::unordered_map<uint32_t, int> capacities = this->capacityChanges;
+    std::unordered_map<uint32_t, int> flows = this->flowChanges;
+
+    for (const BranchLayer* layer = this->parent.get(); layer; layer = layer->parent.get()) {
+        for (const auto& [arc, capacity] : layer->capacities) capacities.try_emplace(arc, capacity);
+        for (const auto& [arc, flow] : layer->flows) flows.try_emplace(arc, flow);
+    }
+
+    for (const auto& [arc, _] : capacities) flows.try_emplace(arc, arcs.flow(arc));
+    for (const auto& [arc, _] : flows) capacities.try_emplace(arc, arcs.capacities[arc]);
+
+    warmStart = true;
+
+    for (const auto& [arc, flow] : flows) {
+        int capacity = capacities[arc];
+
+        if (flow > capacity) warmStart = false;
+
+        residuals[arc] = capacity - flow;
+        residuals[arcs.reverses[arc]] = flow;
+    }
+
+    if (warmStart) return residuals;
+
+    // a capacity cut below the inherited flow leaves no feasible warm start, so the branch starts from zero flow
+    for (uint32_t arc = 0; arc < arcs.arcCount(); arc++) residuals[arc] = arcs.forward[arc] ? arcs.capacities[arc] : 0;
+
+    for (const auto& [arc, capacity] : capacities) residuals[arc] = capacity;
+
+    return residuals;
+};
+
+void NetworkBranch::setCapacity(std::string start, std::string end, int capacity)
+{
+    if (capacity < 0) throw std::runtime_error("NetworkBranch setCapacity: edge capacity cannot be negative");
+
+    uint32_t arc = this->root->findEdgeArc(start, end);
+
+    if (capacity == this->inheritedCapacity(arc)) this->capacityChanges.erase(arc);
+    else this->capacityChanges[arc] = capacity;
+};
+
+void NetworkBranch::setVertexCapacity(std::string node, int capacity)
+{
+    this->setCapacity(node + "-in", node + "-out", capacity);
+    this->setCapacity(node + "-out", node + "-in", capacity);
+};
+
+int NetworkBranch::getEdgeFlow(std::string start, std::string end) const
+{
+    return this->flowOf(this->root->findEdgeArc(start, end));
+};
+
+int NetworkBranch::getFlow() const
+{
+    const ResidualArcs& arcs = this->root->getResidualArcs();
+
+    int sum = 0;
+
+    for (const auto& sourceIndex : this->root->getSourceIndices()) {
+        for (uint32_t arc = arcs.offsets[sourceIndex]; arc < arcs.offsets[sourceIndex + 1]; arc++) if (arcs.forward[arc]) sum += this->flowOf(arc);
+    }
+
+    return sum;
+};
+
+std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> NetworkBranch::findMinCut() const
+{
+    const ResidualArcs& arcs = this->root->getResidualArcs();
+    const std::vector<std::string>& nodes = this->root->getNodes();
+
+    bool warmStart;
+    std::vector<int> residuals = this->materializeResiduals(warmStart);
+
+    SolverWorkspace& workspace = workspaceFor(arcs);
+
+    markReachable(arcs, residuals.data(), this->root->getSourceIndices(), workspace);
+
+    std::unordered_set<std::string> reachableFromSource;
+    std::unordered_set<std::string> unreachableFromSource;
+
+    for (uint32_t node = 0; node < nodes.size(); node++) {
+        if (workspace.isVisited(node)) reachableFromSource.emplace(nodes[node]);
+        else unreachableFromSource.emplace(nodes[node]);
+    }
+
+    return { reachableFromSource, unreachableFromSource };
+};
+
+void NetworkBranch::maximizeFlow()
+{
+    const ResidualArcs& arcs = this->root->getResidualArcs();
+
+    bool warmStart;
+    std::vector<int> residuals = this->materializeResiduals(warmStart);
+
+    SolverWorkspace& workspace = workspaceFor(arcs);
+
+    std::vector<uint32_t> pathArcs;
+
+    while (augmentShortestPath(arcs, residuals.data(), this->root->getSourceIndices(), this->root->getTerminalMask(), workspace, &pathArcs));
+
+    if (warmStart) {
+        // every other arc still carries the flow it started with, so only the arcs the paths crossed can change
+        for (auto& arc : pathArcs) if (!arcs.forward[arc]) arc = arcs.reverses[arc];
+
+        std::sort(pathArcs.begin(), pathArcs.end());
+        pathArcs.erase(std::unique(pathArcs.begin(), pathArcs.end()), pathArcs.end());
+
+        for (const auto& arc : pathArcs) {
+            int flow = residuals[arcs.reverses[arc]];
+
+            if (flow != this->inheritedFlow(arc)) this->flowChanges[arc] = flow;
+            else this->flowChanges.erase(arc);
+        }
+
+        return;
+    }
+
+    // a cold start changed every flow, so compare against the inherited flows of every arc, built once
+    std::vector<int> inheritedFlows(arcs.arcCount());
+
+    for (uint32_t arc = 0; arc < arcs.arcCount(); arc++) if (arcs.forward[arc]) inheritedFlows[arc] = arcs.flow(arc);
+
+    std::vector<const BranchLayer*> layers;
+
+    for (const BranchLayer* layer = this->parent.get(); layer; layer = layer->parent.get()) layers.push_back(layer);
+
+    for (auto layer = layers.rbegin(); layer != layers.rend(); layer++) for (const auto& [arc, flow] : (*layer)->flows) inheritedFlows[arc] = flow;
+
+    this->flowChanges.clear();
+
+    for (uint32_t arc = 0; arc < arcs.arcCount(); arc++) {
+        if (!arcs.forward[arc]) continue;
+
+        int flow = residuals[arcs.reverses[arc]];
+
+        if (flow != inheritedFlows[arc]) this->flowChanges[arc] = flow;
+    }
+};
+
+size_t NetworkBranch::getChangeCount() const
+{
+    size_t changeCount = this->capacityChanges.size() + this->flowChanges.size();
+
+    for (const BranchLayer* layer = this->parent.get(); layer; layer = layer->parent.get()) changeCount += layer->capacities.size() + layer->flows.size();
+
+    return changeCount;
+};
@@ -0,0 +1,64 @@
+#ifndef NETWORK_BRANCH
+#define NETWORK_BRANCH
+
+#include <memory>
+
+#include "flow_capacitated_networks.hpp"
+
+class BranchLayer
+{
+    public:
+        std::shared_ptr<const BranchLayer> parent;
+
+        // keyed by forward arc, holding only the arcs that differ from the parent layer
+        std::unordered_map<uint32_t, int> capacities;
+        std::unordered_map<uint32_t, int> flows;
+};
+
+// A what-if copy of a network that shares topology, capacities and flow with the network it was branched from.
+// Only the capacities it changes and the flows that differ after solving are stored, so a branch costs memory
+// in proportion to its changes. Branching freezes the current changes into a layer shared by both branches.
+//
+// The search needs dense residuals, so maximizeFlow() and findMinCut() copy the root's once, O(E), and apply the
+// changes of every layer once each. A solve then only records the arcs its augmenting paths crossed, unless a
+// capacity cut below the inherited flow forces a start from zero flow, which compares every arc again in O(E).
+class NetworkBranch
+{
+    private:
+        std::shared_ptr<const FlowCapacitatedNetwork> root;
+        std::shared_ptr<const BranchLayer> parent;
+
+        std::unordered_map<uint32_t, int> capacityChanges;
+        std::unordered_map<uint32_t, int> flowChanges;
+
+        NetworkBranch(std::shared_ptr<const FlowCapacitatedNetwork> root, std::shared_ptr<const BranchLayer> parent);
+
+        int inheritedCapacity(uint32_t arc) const;
+        int inheritedFlow(uint32_t arc) const;
+
+        int capacityOf(uint32_t arc) const;
+        int flowOf(uint32_t arc) const;
+
+        // the root's residuals with every layer's changes applied, warmStart false when those changes left some flow
+        // above its capacity and the residuals start from zero flow instead
+        std::vector<int> materializeResiduals(bool& warmStart) const;
+
+    public:
+        NetworkBranch(std::shared_ptr<const FlowCapacitatedNetwork> root);
+
+        NetworkBranch branch();
+
+        void setCapacity(std::string start, std::string end, int capacity);
+        void setVertexCapacity(std::string node, int capacity);
+
+        int getEdgeFlow(std::string start, std::string end) const;
+        int getFlow() const;
+
+        std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> findMinCut() const;
+
+        void maximizeFlow();
+
+        size_t getChangeCount() const;
+};
+
+#endif
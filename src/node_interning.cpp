@@ -0,0 +1,91 @@
+#include <array>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "node_interning.hpp"
+#include "parallel_chunks.hpp"
+
+constexpr size_t shardCount = 64;
+
+size_t shardOf(std::string_view name)
+{
+    return std::hash<std::string_view>()(name) % shardCount;
+};
+
+InternedEdgeList internEdgeList(const std::vector<Edge>& edges, const std::vector<std::string>& boundaryNodes, unsigned threadCount)
+{
+    threadCount = resolveThreadCount(threadCount);
+
+    if (edges.size() >= UINT32_MAX / 2) throw std::runtime_error("internEdgeList: too many edges to index");
+
+    // endpoint 2 * i is the start of edges[i] and endpoint 2 * i + 1 is its end
+    size_t endpointCount = edges.size() * 2;
+
+    auto endpointName = [&](size_t endpoint) -> std::string_view {
+        const Edge& edge = edges[endpoint / 2];
+
+        return endpoint % 2 == 0 ? edge.start : edge.end;
+    };
+
+    std::vector<std::array<std::vector<uint32_t>, shardCount>> buckets(threadCount);
+    std::vector<uint8_t> endpointShards(endpointCount);
+
+    forEachChunk(endpointCount, threadCount, [&](size_t begin, size_t end, unsigned chunk) {
+        for (size_t endpoint = begin; endpoint < end; endpoint++) {
+            size_t shard = shardOf(endpointName(endpoint));
+
+            endpointShards[endpoint] = shard;
+            buckets[chunk][shard].push_back(endpoint);
+        }
+    });
+
+    std::vector<std::vector<std::string_view>> shardNodes(shardCount);
+    std::vector<uint32_t> localIndices(endpointCount);
+    std::vector<uint32_t> boundaryLocalIndices(boundaryNodes.size());
+
+    forEachChunk(shardCount, threadCount, [&](size_t begin, size_t end, unsigned) {
+        for (size_t shard = begin; shard < end; shard++) {
+            std::unordered_map<std::string_view, uint32_t> shardIndices;
+
+            auto intern = [&](std::string_view name) {
+                auto [found, inserted] = shardIndices.try_emplace(name, shardNodes[shard].size());
+
+                if (inserted) shardNodes[shard].push_back(name);
+
+                return found->second;
+            };
+
+            for (size_t i = 0; i < boundaryNodes.size(); i++) if (shardOf(boundaryNodes[i]) == shard) boundaryLocalIndices[i] = intern(boundaryNodes[i]);
+
+            for (const auto& chunkBuckets : buckets) {
+                for (const auto& endpoint : chunkBuckets[shard]) localIndices[endpoint] = intern(endpointName(endpoint));
+            }
+        }
+    });
+
+    std::vector<uint32_t> shardOffsets(shardCount + 1, 0);
+
+    for (size_t shard = 0; shard < shardCount; shard++) shardOffsets[shard + 1] = shardOffsets[shard] + shardNodes[shard].size();
+
+    InternedEdgeList interned;
+    interned.nodes.resize(shardOffsets[shardCount]);
+    interned.edges.resize(edges.size());
+
+    forEachChunk(shardCount, threadCount, [&](size_t begin, size_t end, unsigned) {
+        for (size_t shard = begin; shard < end; shard++) std::copy(shardNodes[shard].begin(), shardNodes[shard].end(), interned.nodes.begin() + shardOffsets[shard]);
+    });
+
+    forEachChunk(edges.size(), threadCount, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++) {
+            uint32_t startIndex = shardOffsets[endpointShards[2 * i]] + localIndices[2 * i];
+            uint32_t endIndex = shardOffsets[endpointShards[2 * i + 1]] + localIndices[2 * i + 1];
+
+            interned.edges[i] = IndexedEdge(startIndex, endIndex, edges[i].capacity);
+        }
+    });
+
+    for (size_t i = 0; i < boundaryNodes.size(); i++) interned.boundaryIndices.push_back(shardOffsets[shardOf(boundaryNodes[i])] + boundaryLocalIndices[i]);
+
+    return interned;
+};
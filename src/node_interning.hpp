@@ -0,0 +1,23 @@
+#ifndef NODE_INTERNING
+#define NODE_INTERNING
+
+#include <string_view>
+
+#include "flow_capacitated_networks.hpp"
+
+// Node names are views into the edges and boundary names they were interned from, which must outlive them.
+class InternedEdgeList
+{
+    public:
+        std::vector<std::string_view> nodes;
+        std::vector<IndexedEdge> edges;
+
+        // node index of every boundary node, in the order they were passed
+        std::vector<uint32_t> boundaryIndices;
+};
+
+// Names are hashed into shards in parallel, then every shard is interned by a single thread without locking.
+// Node indices follow shard order, and first appearance within a shard, whatever the thread count.
+InternedEdgeList internEdgeList(const std::vector<Edge>& edges, const std::vector<std::string>& boundaryNodes, unsigned threadCount);
+
+#endif
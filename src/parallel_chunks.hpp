@@ -0,0 +1,51 @@
+#ifndef PARALLEL_CHUNKS
+#define PARALLEL_CHUNKS
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+// 0 asks for every hardware thread
+inline unsigned resolveThreadCount(unsigned threadCount)
+{
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+
+    return std::max(threadCount, 1u);
+};
+
+// Splits [0, count) into threadCount contiguous chunks and runs work(begin, end, chunk) on each, one per thread.
+// Chunk boundaries depend only on count and threadCount, so passes over the same range line up chunk for chunk.
+// Empty chunks are skipped without starting a thread.
+// The exception thrown by the lowest failing chunk is rethrown once every chunk has finished.
+template <typename Work>
+void forEachChunk(size_t count, unsigned threadCount, Work work)
+{
+    std::vector<std::exception_ptr> errors(threadCount);
+
+    auto chunkBegin = [&](unsigned chunk) { return count * chunk / threadCount; };
+
+    auto runChunk = [&](unsigned chunk) {
+        if (chunkBegin(chunk) == chunkBegin(chunk + 1)) return;
+
+        try {
+            work(chunkBegin(chunk), chunkBegin(chunk + 1), chunk);
+        }
+        catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (unsigned chunk = 1; chunk < threadCount; chunk++) if (chunkBegin(chunk) != chunkBegin(chunk + 1)) threads.emplace_back(runChunk, chunk);
+
+    runChunk(0);
+
+    for (auto& thread : threads) thread.join();
+
+    for (const auto& error : errors) if (error) std::rethrow_exception(error);
+};
+
+#endif
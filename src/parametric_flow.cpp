@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <climits>
+#include <numeric>
+#include <stdexcept>
+
+#include "parametric_flow.hpp"
+#include "augmenting_paths.hpp"
+
+double ParametricCut::getCapacity(double lambda) const
+{
+    return this->constant + this->slope * lambda;
+};
+
+double ParametricFlow::getFlow(double lambda) const
+{
+    return this->getMinCut(lambda).getCapacity(lambda);
+};
+
+const ParametricCut& ParametricFlow::getMinCut(double lambda) const
+{
+    size_t segment = std::upper_bound(this->breakpoints.begin(), this->breakpoints.end(), lambda) - this->breakpoints.begin();
+
+    return this->cuts[segment];
+};
+
+class ParametricSolver
+{
+    public:
+        const FlowCapacitatedNetwork& network;
+        const ResidualArcs& arcs;
+
+        // slope of every arc, zero on reverse arcs and on edges that do not vary with lambda
+        std::vector<int> slopes;
+
+        std::vector<ParametricCut> cuts;
+
+        ParametricSolver(const FlowCapacitatedNetwork& network): network(network), arcs(network.getResidualArcs()), slopes(network.getResidualArcs().arcCount(), 0) {};
+
+        std::vector<bool> solveBetween(const std::vector<bool>& lowerSide, const std::vector<bool>& upperSide, int64_t numerator, int64_t denominator);
+        ParametricCut describeCut(const std::vector<bool>& side);
+        void findBreakpoints(const ParametricCut& lower, const std::vector<bool>& lowerSide, const ParametricCut& upper, const std::vector<bool>& upperSide);
+};
+
+// Minimum cut with the smallest source side at lambda = numerator / denominator among the cuts whose source side
+// lies between lowerSide and upperSide. Nodes outside that range are contracted into one source and one terminal.
+std::vector<bool> ParametricSolver::solveBetween(const std::vector<bool>& lowerSide, const std::vector<bool>& upperSide, int64_t numerator, int64_t denominator)
+{
+    constexpr uint32_t contractedSource = 0;
+    constexpr uint32_t contractedTerminal = 1;
+
+    uint32_t nodeCount = this->arcs.nodeCount();
+
+    std::vector<uint32_t> contracted(nodeCount);
+    uint32_t contractedCount = 2;
+
+    for (uint32_t node = 0; node < nodeCount; node++) {
+        if (lowerSide[node]) contracted[node] = contractedSource;
+        else if (!upperSide[node]) contracted[node] = contractedTerminal;
+        else contracted[node] = contractedCount++;
+    }
+
+    std::vector<IndexedEdge> edges;
+
+    for (uint32_t node = 0; node < nodeCount; node++) {
+        for (uint32_t arc = this->arcs.offsets[node]; arc < this->arcs.offsets[node + 1]; arc++) {
+            uint32_t start = contracted[node];
+            uint32_t end = contracted[this->arcs.heads[arc]];
+
+            if (!this->arcs.forward[arc] || start == end || end == contractedSource || start == contractedTerminal) continue;
+
+            // capacities are scaled by the denominator so a fractional lambda keeps integral capacities
+            int64_t capacity = this->arcs.capacities[arc] * denominator + this->slopes[arc] * numerator;
+
+            if (capacity > INT_MAX) throw std::runtime_error("solveParametricFlow: capacities scaled to a breakpoint overflow int");
+
+            if (capacity > 0) edges.emplace_back(start, end, capacity);
+        }
+    }
+
+    ResidualArcs contractedArcs(contractedCount, edges);
+
+    std::vector<uint32_t> sourceIndices = { contractedSource };
+    std::vector<bool> terminalMask(contractedCount, false);
+    terminalMask[contractedTerminal] = true;
+
+    SolverWorkspace& workspace = workspaceFor(contractedArcs);
+
+    while (augmentShortestPath(contractedArcs, contractedArcs.residuals.data(), sourceIndices, terminalMask, workspace));
+
+    markReachable(contractedArcs, contractedArcs.residuals.data(), sourceIndices, workspace);
+
+    std::vector<bool> side(nodeCount);
+
+    for (uint32_t node = 0; node < nodeCount; node++) side[node] = workspace.isVisited(contracted[node]);
+
+    return side;
+};
+
+ParametricCut ParametricSolver::describeCut(const std::vector<bool>& side)
+{
+    ParametricCut cut { 0, 0, {} };
+
+    for (uint32_t node = 0; node < this->arcs.nodeCount(); node++) {
+        if (!side[node]) continue;
+
+        cut.sourceSide.insert(this->network.getNodes()[node]);
+
+        for (uint32_t arc = this->arcs.offsets[node]; arc < this->arcs.offsets[node + 1]; arc++) {
+            if (!this->arcs.forward[arc] || side[this->arcs.heads[arc]]) continue;
+
+            cut.constant += this->arcs.capacities[arc];
+            cut.slope += this->slopes[arc];
+        }
+    }
+
+    return cut;
+};
+
+// appends the minimum cuts strictly between lower and upper, in order of increasing lambda
+void ParametricSolver::findBreakpoints(const ParametricCut& lower, const std::vector<bool>& lowerSide, const ParametricCut& upper, const std::vector<bool>& upperSide)
+{
+    // source sides only grow with lambda, which can only shed source edges and gain terminal edges, so slopes only fall
+    if (lower.slope <= upper.slope) return;
+
+    // lambda where the two cut lines cross
+    int64_t numerator = upper.constant - lower.constant;
+    int64_t denominator = lower.slope - upper.slope;
+
+    int64_t divisor = std::gcd(numerator, denominator);
+
+    numerator /= divisor;
+    denominator /= divisor;
+
+    std::vector<bool> middleSide = this->solveBetween(lowerSide, upperSide, numerator, denominator);
+    ParametricCut middle = this->describeCut(middleSide);
+
+    // nothing dips below the crossing, so it is a breakpoint between lower and upper
+    if (middle.constant * denominator + middle.slope * numerator == lower.constant * denominator + lower.slope * numerator) return;
+
+    this->findBreakpoints(lower, lowerSide, middle, middleSide);
+    this->cuts.push_back(middle);
+    this->findBreakpoints(middle, middleSide, upper, upperSide);
+};
+
+ParametricFlow solveParametricFlow(const FlowCapacitatedNetwork& network, const std::unordered_map<std::pair<std::string, std::string>, int>& slopes, int lambdaMin, int lambdaMax)
+{
+    if (lambdaMin > lambdaMax) throw std::runtime_error("solveParametricFlow: lambdaMin cannot exceed lambdaMax");
+
+    ParametricSolver solver(network);
+
+    const ResidualArcs& arcs = network.getResidualArcs();
+    const std::vector<uint32_t>& sourceIndices = network.getSourceIndices();
+    const std::vector<bool>& terminalMask = network.getTerminalMask();
+
+    for (const auto& [edge, slope] : slopes) {
+        uint32_t arc = network.findEdgeArc(edge.first, edge.second);
+
+        bool leavesSource = std::find(sourceIndices.begin(), sourceIndices.end(), network.getNodeIndex(edge.first)) != sourceIndices.end();
+        bool entersTerminal = terminalMask[network.getNodeIndex(edge.second)];
+
+        if (slope > 0 && !leavesSource) throw std::runtime_error("solveParametricFlow: only edges leaving a source can increase with lambda");
+        if (slope < 0 && !entersTerminal) throw std::runtime_error("solveParametricFlow: only edges entering a terminal can decrease with lambda");
+
+        if (arcs.capacities[arc] + int64_t(slope) * lambdaMin < 0 || arcs.capacities[arc] + int64_t(slope) * lambdaMax < 0) throw std::runtime_error("solveParametricFlow: edge capacity cannot be negative over the lambda range");
+
+        solver.slopes[arc] = slope;
+    }
+
+    uint32_t nodeCount = arcs.nodeCount();
+
+    std::vector<bool> sourceSide(nodeCount, false);
+    std::vector<bool> nonTerminalSide(nodeCount);
+
+    for (const auto& sourceIndex : sourceIndices) sourceSide[sourceIndex] = true;
+    for (uint32_t node = 0; node < nodeCount; node++) nonTerminalSide[node] = !terminalMask[node];
+
+    std::vector<bool> lowerSide = solver.solveBetween(sourceSide, nonTerminalSide, lambdaMin, 1);
+    std::vector<bool> upperSide = solver.solveBetween(lowerSide, nonTerminalSide, lambdaMax, 1);
+
+    ParametricCut lower = solver.describeCut(lowerSide);
+    ParametricCut upper = solver.describeCut(upperSide);
+
+    solver.cuts.push_back(lower);
+    solver.findBreakpoints(lower, lowerSide, upper, upperSide);
+
+    if (upper.slope < lower.slope) solver.cuts.push_back(upper);
+
+    ParametricFlow parametricFlow;
+    parametricFlow.cuts = std::move(solver.cuts);
+
+    for (size_t i = 0; i + 1 < parametricFlow.cuts.size(); i++) {
+        const ParametricCut& left = parametricFlow.cuts[i];
+        const ParametricCut& right = parametricFlow.cuts[i + 1];
+
+        parametricFlow.breakpoints.push_back(double(right.constant - left.constant) / double(left.slope - right.slope));
+    }
+
+    return parametricFlow;
+};
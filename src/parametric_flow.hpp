@@ -0,0 +1,37 @@
+#ifndef PARAMETRIC_FLOW
+#define PARAMETRIC_FLOW
+
+#include "flow_capacitated_networks.hpp"
+
+// An edge with slope s has capacity c + s * lambda, where c is its capacity in the network. Positive slopes are only
+// allowed on edges leaving a source and negative slopes on edges entering a terminal, so minimum cuts are nested:
+// their source sides only grow as lambda increases.
+
+class ParametricCut
+{
+    public:
+        // the cut capacity is constant + slope * lambda
+        int64_t constant;
+        int64_t slope;
+
+        std::unordered_set<std::string> sourceSide;
+
+        double getCapacity(double lambda) const;
+};
+
+class ParametricFlow
+{
+    public:
+        // cuts[i] is a minimum cut between breakpoints[i - 1] and breakpoints[i], ordered by increasing lambda
+        std::vector<ParametricCut> cuts;
+        std::vector<double> breakpoints;
+
+        double getFlow(double lambda) const;
+        const ParametricCut& getMinCut(double lambda) const;
+};
+
+// Finds every breakpoint of max flow as a function of lambda over [lambdaMin, lambdaMax]. Each solve runs on the
+// network contracted between the two nested cuts bracketing it, so nodes settled by earlier solves are not searched again.
+ParametricFlow solveParametricFlow(const FlowCapacitatedNetwork& network, const std::unordered_map<std::pair<std::string, std::string>, int>& slopes, int lambdaMin, int lambdaMax);
+
+#endif
@@ -0,0 +1,102 @@
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "perf_counters.hpp"
+
+const std::vector<std::string>& PerfCounters::getCounterNames()
+{
+    static const std::vector<std::string> names = { "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses" };
+
+    return names;
+};
+
+#ifdef __linux__
+
+int openCounter(uint32_t type, uint64_t config)
+{
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+
+    attributes.size = sizeof(attributes);
+    attributes.type = type;
+    attributes.config = config;
+    attributes.disabled = 1;
+
+    // user space only, which unprivileged containers are usually still allowed to count
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    // threads started while counting, like the workers of a parallel construction, add into the same reading
+    attributes.inherit = 1;
+
+    return syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+};
+
+PerfCounters::PerfCounters()
+{
+    constexpr uint64_t l1dReadMisses = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    this->fds = {
+        openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES),
+        openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS),
+        openCounter(PERF_TYPE_HW_CACHE, l1dReadMisses),
+        openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES),
+        openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES),
+    };
+};
+
+PerfCounters::~PerfCounters()
+{
+    for (const auto& fd : this->fds) if (fd >= 0) close(fd);
+};
+
+void PerfCounters::start()
+{
+    for (const auto& fd : this->fds) {
+        if (fd < 0) continue;
+
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+};
+
+std::vector<std::optional<uint64_t>> PerfCounters::stop()
+{
+    std::vector<std::optional<uint64_t>> readings;
+
+    for (const auto& fd : this->fds) {
+        uint64_t value;
+
+        if (fd >= 0 && ioctl(fd, PERF_EVENT_IOC_DISABLE, 0) == 0 && read(fd, &value, sizeof(value)) == sizeof(value)) readings.push_back(value);
+        else readings.push_back(std::nullopt);
+    }
+
+    return readings;
+};
+
+#else
+
+PerfCounters::PerfCounters(): fds(getCounterNames().size(), -1) {};
+
+PerfCounters::~PerfCounters() {};
+
+void PerfCounters::start() {};
+
+std::vector<std::optional<uint64_t>> PerfCounters::stop()
+{
+    return std::vector<std::optional<uint64_t>>(this->fds.size());
+};
+
+#endif
+
+bool PerfCounters::isAvailable() const
+{
+    for (const auto& fd : this->fds) if (fd >= 0) return true;
+
+    return false;
+};
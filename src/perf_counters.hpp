@@ -0,0 +1,34 @@
+#ifndef PERF_COUNTERS
+#define PERF_COUNTERS
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Hardware counters for the calling thread and every thread it starts, through Linux perf_event_open. Threads that
+// already exist when the counters are opened are not included. Each counter is opened on its own, so a kernel,
+// container or virtual machine that refuses some of them still reports the rest, and a counter that could not be
+// opened reads as empty. Elsewhere every counter is unavailable.
+class PerfCounters
+{
+    private:
+        std::vector<int> fds;
+
+    public:
+        PerfCounters();
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        // cycles, instructions, L1 data read misses, last level cache misses and branch misses, in reading order
+        static const std::vector<std::string>& getCounterNames();
+
+        bool isAvailable() const;
+
+        void start();
+        std::vector<std::optional<uint64_t>> stop();
+};
+
+#endif
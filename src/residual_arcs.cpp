@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <climits>
+#include <bit>
+#include <numeric>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RESIDUAL_ARCS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+#include "residual_arcs.hpp"
+#include "parallel_chunks.hpp"
+
+ResidualArcs::ResidualArcs(uint32_t nodeCount, const std::vector<IndexedEdge>& edges)
+{
+    this->offsets.assign(nodeCount + 1, 0);
+
+    for (const auto& edge : edges) {
+        this->offsets[edge.start + 1]++;
+        this->offsets[edge.end + 1]++;
+    }
+
+    for (uint32_t node = 0; node < nodeCount; node++) this->offsets[node + 1] += this->offsets[node];
+
+    uint32_t arcCount = this->offsets[nodeCount];
+
+    this->heads.resize(arcCount);
+    this->reverses.resize(arcCount);
+    this->residuals.resize(arcCount);
+    this->capacities.resize(arcCount);
+    this->forward.resize(arcCount);
+
+    std::vector<uint32_t> nextArc(this->offsets.begin(), this->offsets.end() - 1);
+
+    for (const auto& edge : edges) {
+        uint32_t forwardArc = nextArc[edge.start]++;
+        uint32_t reverseArc = nextArc[edge.end]++;
+
+        this->heads[forwardArc] = edge.end;
+        this->reverses[forwardArc] = reverseArc;
+        this->residuals[forwardArc] = edge.capacity;
+        this->capacities[forwardArc] = edge.capacity;
+        this->forward[forwardArc] = true;
+
+        this->heads[reverseArc] = edge.start;
+        this->reverses[reverseArc] = forwardArc;
+        this->residuals[reverseArc] = 0;
+        this->capacities[reverseArc] = 0;
+        this->forward[reverseArc] = false;
+    }
+};
+
+ResidualArcs::ResidualArcs(uint32_t nodeCount, const std::vector<IndexedEdge>& edges, unsigned threadCount)
+{
+    threadCount = resolveThreadCount(threadCount);
+
+    // every chunk keeps a count per node and every node pass walks all of them, so chunks are capped at the average
+    // degree, which keeps that scratch under a quarter of the arc arrays and the work linear in the edges
+    threadCount = std::min<size_t>(threadCount, std::max<size_t>(2 * edges.size() / std::max(nodeCount, 1u), 1));
+
+    // nextArcs[chunk][v] counts the arcs chunk places at v, then becomes the first slot chunk writes at v, and stays
+    // empty for a chunk with no edges
+    std::vector<std::vector<uint32_t>> nextArcs(threadCount);
+
+    forEachChunk(edges.size(), threadCount, [&](size_t begin, size_t end, unsigned chunk) {
+        nextArcs[chunk].assign(nodeCount, 0);
+
+        for (size_t i = begin; i < end; i++) {
+            nextArcs[chunk][edges[i].start]++;
+            nextArcs[chunk][edges[i].end]++;
+        }
+    });
+
+    this->offsets.assign(nodeCount + 1, 0);
+
+    forEachChunk(nodeCount, threadCount, [&](size_t begin, size_t end, unsigned) {
+        for (size_t node = begin; node < end; node++) {
+            uint32_t degree = 0;
+
+            for (auto& counts : nextArcs) {
+                if (counts.empty()) continue;
+
+                uint32_t count = counts[node];
+                counts[node] = degree;
+                degree += count;
+            }
+
+            this->offsets[node + 1] = degree;
+        }
+    });
+
+    // two pass scan: sum every block of nodes, then let each block add the sums of the blocks before it
+    std::vector<uint32_t> blockSums(threadCount, 0);
+
+    forEachChunk(nodeCount, threadCount, [&](size_t begin, size_t end, unsigned chunk) {
+        for (size_t node = begin; node < end; node++) blockSums[chunk] += this->offsets[node + 1];
+    });
+
+    std::exclusive_scan(blockSums.begin(), blockSums.end(), blockSums.begin(), 0u);
+
+    forEachChunk(nodeCount, threadCount, [&](size_t begin, size_t end, unsigned chunk) {
+        uint32_t offset = blockSums[chunk];
+
+        for (size_t node = begin; node < end; node++) {
+            uint32_t degree = this->offsets[node + 1];
+
+            for (auto& counts : nextArcs) if (!counts.empty()) counts[node] += offset;
+
+            offset += degree;
+            this->offsets[node + 1] = offset;
+        }
+    });
+
+    uint32_t arcCount = this->offsets[nodeCount];
+
+    this->heads.resize(arcCount);
+    this->reverses.resize(arcCount);
+    this->residuals.resize(arcCount);
+    this->capacities.resize(arcCount);
+    this->forward.resize(arcCount);
+
+    forEachChunk(edges.size(), threadCount, [&](size_t begin, size_t end, unsigned chunk) {
+        std::vector<uint32_t>& nextArc = nextArcs[chunk];
+
+        for (size_t i = begin; i < end; i++) {
+            const IndexedEdge& edge = edges[i];
+
+            uint32_t forwardArc = nextArc[edge.start]++;
+            uint32_t reverseArc = nextArc[edge.end]++;
+
+            this->heads[forwardArc] = edge.end;
+            this->reverses[forwardArc] = reverseArc;
+            this->residuals[forwardArc] = edge.capacity;
+            this->capacities[forwardArc] = edge.capacity;
+            this->forward[forwardArc] = true;
+
+            this->heads[reverseArc] = edge.start;
+            this->reverses[reverseArc] = forwardArc;
+            this->residuals[reverseArc] = 0;
+            this->capacities[reverseArc] = 0;
+            this->forward[reverseArc] = false;
+        }
+    });
+};
+
+uint32_t ResidualArcs::nodeCount() const
+{
+    return this->offsets.empty() ? 0 : this->offsets.size() - 1;
+};
+
+uint32_t ResidualArcs::arcCount() const
+{
+    return this->heads.size();
+};
+
+uint32_t ResidualArcs::maxDegree() const
+{
+    uint32_t degree = 0;
+
+    for (uint32_t node = 0; node < this->nodeCount(); node++) degree = std::max(degree, this->offsets[node + 1] - this->offsets[node]);
+
+    return degree;
+};
+
+int ResidualArcs::residual(uint32_t arc) const
+{
+    if (this->hasResidualBits()) return (this->residualBits[arc / 64] >> (arc % 64)) & 1;
+
+    return this->residuals[arc];
+};
+
+int ResidualArcs::flow(uint32_t arc) const
+{
+    return this->forward[arc] ? this->capacities[arc] - this->residual(arc) : 0;
+};
+
+void ResidualArcs::resetFlow()
+{
+    if (!this->hasResidualBits()) {
+        std::copy(this->capacities.begin(), this->capacities.end(), this->residuals.begin());
+        return;
+    }
+
+    // packed capacities are 0 or 1, so each residual bit starts out as its arc's capacity
+    std::fill(this->residualBits.begin(), this->residualBits.end(), 0);
+
+    for (uint32_t arc = 0; arc < this->arcCount(); arc++) this->residualBits[arc / 64] |= uint64_t(this->capacities[arc]) << (arc % 64);
+};
+
+bool ResidualArcs::hasResidualBits() const
+{
+    return !this->residualBits.empty();
+};
+
+void ResidualArcs::unpackResiduals()
+{
+    if (!this->hasResidualBits()) return;
+
+    this->residuals.resize(this->arcCount());
+
+    for (uint32_t arc = 0; arc < this->arcCount(); arc++) this->residuals[arc] = this->residual(arc);
+
+    AlignedVector<uint64_t>().swap(this->residualBits);
+};
+
+bool ResidualArcs::hasReverses() const
+{
+    return this->reverses.size() == this->heads.size();
+};
+
+void ResidualArcs::dropReverses()
+{
+    AlignedVector<uint32_t>().swap(this->reverses);
+};
+
+void ResidualArcs::restoreReverses()
+{
+    if (this->hasReverses()) return;
+
+    uint32_t nodeCount = this->nodeCount();
+
+    // group the reverse arcs by the node they point back to, which is the tail of their forward arc
+    std::vector<uint32_t> reverseOffsets(nodeCount + 1, 0);
+
+    for (uint32_t arc = 0; arc < this->arcCount(); arc++) if (!this->forward[arc]) reverseOffsets[this->heads[arc] + 1]++;
+
+    for (uint32_t node = 0; node < nodeCount; node++) reverseOffsets[node + 1] += reverseOffsets[node];
+
+    std::vector<uint32_t> reverseArcs(reverseOffsets[nodeCount]);
+    std::vector<uint32_t> nextReverse(reverseOffsets.begin(), reverseOffsets.end() - 1);
+    std::vector<uint32_t> reverseTails(this->arcCount());
+
+    for (uint32_t node = 0; node < nodeCount; node++) {
+        for (uint32_t arc = this->offsets[node]; arc < this->offsets[node + 1]; arc++) {
+            reverseTails[arc] = node;
+
+            if (!this->forward[arc]) reverseArcs[nextReverse[this->heads[arc]]++] = arc;
+        }
+    }
+
+    this->reverses.resize(this->arcCount());
+
+    std::vector<uint32_t> forwardArcs;
+
+    // edges between a pair of nodes are unique, so sorting both sides by the far node pairs every arc with its reverse
+    for (uint32_t node = 0; node < nodeCount; node++) {
+        forwardArcs.clear();
+
+        for (uint32_t arc = this->offsets[node]; arc < this->offsets[node + 1]; arc++) if (this->forward[arc]) forwardArcs.push_back(arc);
+
+        auto backArcs = reverseArcs.begin() + reverseOffsets[node];
+        auto backArcsEnd = reverseArcs.begin() + reverseOffsets[node + 1];
+
+        std::sort(forwardArcs.begin(), forwardArcs.end(), [&](uint32_t left, uint32_t right) { return this->heads[left] < this->heads[right]; });
+        std::sort(backArcs, backArcsEnd, [&](uint32_t left, uint32_t right) { return reverseTails[left] < reverseTails[right]; });
+
+        for (size_t i = 0; i < forwardArcs.size(); i++) {
+            this->reverses[forwardArcs[i]] = backArcs[i];
+            this->reverses[backArcs[i]] = forwardArcs[i];
+        }
+    }
+};
+
+void ResidualArcs::shrinkToFit()
+{
+    this->offsets.shrink_to_fit();
+    this->heads.shrink_to_fit();
+    this->reverses.shrink_to_fit();
+    this->residuals.shrink_to_fit();
+    this->residualBits.shrink_to_fit();
+    this->capacities.shrink_to_fit();
+    this->forward.shrink_to_fit();
+};
+
+size_t filterPositiveResidualsScalar(const int* residuals, size_t count, uint32_t* selected)
+{
+    size_t selectedCount = 0;
+
+    for (size_t i = 0; i < count; i++) if (residuals[i] > 0) selected[selectedCount++] = i;
+
+    return selectedCount;
+};
+
+int minResidualScalar(const int* residuals, const uint32_t* arcs, size_t count)
+{
+    int minimum = INT_MAX;
+
+    for (size_t i = 0; i < count; i++) minimum = std::min(minimum, residuals[arcs[i]]);
+
+    return minimum;
+};
+
+#ifdef RESIDUAL_ARCS_X86_KERNELS
+
+__attribute__((target("avx2")))
+size_t filterPositiveResidualsAVX2(const int* residuals, size_t count, uint32_t* selected)
+{
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t selectedCount = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(residuals + i));
+
+        uint32_t mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(block, zero)));
+
+        while (mask) {
+            selected[selectedCount++] = i + std::countr_zero(mask);
+            mask &= mask - 1;
+        }
+    }
+
+    for (; i < count; i++) if (residuals[i] > 0) selected[selectedCount++] = i;
+
+    return selectedCount;
+};
+
+__attribute__((target("avx2")))
+int minResidualAVX2(const int* residuals, const uint32_t* arcs, size_t count)
+{
+    __m256i minimum = _mm256_set1_epi32(INT_MAX);
+
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arcs + i));
+
+        minimum = _mm256_min_epi32(minimum, _mm256_i32gather_epi32(residuals, indices, 4));
+    }
+
+    alignas(32) int lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), minimum);
+
+    int result = *std::min_element(lanes, lanes + 8);
+
+    return std::min(result, minResidualScalar(residuals, arcs + i, count - i));
+};
+
+__attribute__((target("avx512f")))
+size_t filterPositiveResidualsAVX512(const int* residuals, size_t count, uint32_t* selected)
+{
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    size_t selectedCount = 0;
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m512i block = _mm512_loadu_si512(residuals + i);
+
+        __mmask16 mask = _mm512_cmpgt_epi32_mask(block, zero);
+
+        __m512i positions = _mm512_add_epi32(lanes, _mm512_set1_epi32(i));
+
+        _mm512_mask_compressstoreu_epi32(selected + selectedCount, mask, positions);
+
+        selectedCount += std::popcount(static_cast<uint32_t>(mask));
+    }
+
+    for (; i < count; i++) if (residuals[i] > 0) selected[selectedCount++] = i;
+
+    return selectedCount;
+};
+
+__attribute__((target("avx512f")))
+int minResidualAVX512(const int* residuals, const uint32_t* arcs, size_t count)
+{
+    __m512i minimum = _mm512_set1_epi32(INT_MAX);
+
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m512i indices = _mm512_loadu_si512(arcs + i);
+
+        __m512i gathered = _mm512_mask_i32gather_epi32(minimum, 0xFFFF, indices, residuals, 4);
+
+        minimum = _mm512_mask_min_epi32(minimum, 0xFFFF, minimum, gathered);
+    }
+
+    alignas(64) int lanes[16];
+    _mm512_store_si512(lanes, minimum);
+
+    int result = *std::min_element(lanes, lanes + 16);
+
+    return std::min(result, minResidualScalar(residuals, arcs + i, count - i));
+};
+
+#endif
+
+class ResidualKernels
+{
+    public:
+        size_t (*filterPositive)(const int*, size_t, uint32_t*);
+        int (*min)(const int*, const uint32_t*, size_t);
+        const char* name;
+};
+
+ResidualKernels selectResidualKernels()
+{
+#ifdef RESIDUAL_ARCS_X86_KERNELS
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f")) return { filterPositiveResidualsAVX512, minResidualAVX512, "avx512" };
+    if (__builtin_cpu_supports("avx2")) return { filterPositiveResidualsAVX2, minResidualAVX2, "avx2" };
+#endif
+
+    return { filterPositiveResidualsScalar, minResidualScalar, "scalar" };
+};
+
+const ResidualKernels& getResidualKernels()
+{
+    static const ResidualKernels kernels = selectResidualKernels();
+
+    return kernels;
+};
+
+size_t filterPositiveResiduals(const int* residuals, size_t count, uint32_t* selected)
+{
+    return getResidualKernels().filterPositive(residuals, count, selected);
+};
+
+int minResidual(const int* residuals, const uint32_t* arcs, size_t count)
+{
+    return getResidualKernels().min(residuals, arcs, count);
+};
+
+const char* residualKernelName()
+{
+    return getResidualKernels().name;
+};
\ No newline at end of file
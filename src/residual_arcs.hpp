@@ -0,0 +1,95 @@
+#ifndef RESIDUAL_ARCS
+#define RESIDUAL_ARCS
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+template <typename T>
+class AlignedAllocator
+{
+    public:
+        using value_type = T;
+
+        static constexpr std::align_val_t alignment { 64 };
+
+        AlignedAllocator() = default;
+
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U>&) {};
+
+        T* allocate(size_t count) { return static_cast<T*>(::operator new(count * sizeof(T), alignment)); };
+        void deallocate(T* pointer, size_t) { ::operator delete(pointer, alignment); };
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U>&) const { return true; };
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+class IndexedEdge
+{
+    public:
+        uint32_t start;
+        uint32_t end;
+        int capacity;
+
+        IndexedEdge() = default;
+        IndexedEdge(uint32_t start, uint32_t end, int capacity): start(start), end(end), capacity(capacity) {};
+};
+
+class ResidualArcs
+{
+    public:
+        // arcs leaving node v occupy [offsets[v], offsets[v + 1]), every edge owns a forward arc and a reverse arc
+        AlignedVector<uint32_t> offsets;
+        AlignedVector<uint32_t> heads;
+        AlignedVector<uint32_t> reverses;
+        AlignedVector<int> residuals;
+        AlignedVector<int> capacities;
+        AlignedVector<uint8_t> forward;
+
+        // a solved unit capacity network keeps one residual bit per arc here and frees residuals
+        AlignedVector<uint64_t> residualBits;
+
+        ResidualArcs() = default;
+        ResidualArcs(uint32_t nodeCount, const std::vector<IndexedEdge>& edges);
+
+        // same arc order as the sequential build, at the cost of one degree count array per thread, so it uses no
+        // more threads than the average degree
+        ResidualArcs(uint32_t nodeCount, const std::vector<IndexedEdge>& edges, unsigned threadCount);
+
+        uint32_t nodeCount() const;
+        uint32_t arcCount() const;
+        uint32_t maxDegree() const;
+
+        int residual(uint32_t arc) const;
+        int flow(uint32_t arc) const;
+
+        void resetFlow();
+
+        // reverses is only needed to augment, so it can be dropped from a solved network and rebuilt from heads later
+        bool hasReverses() const;
+        void dropReverses();
+        void restoreReverses();
+
+        // solvers other than the unit capacity one, and anything writing residuals, need them unpacked first
+        bool hasResidualBits() const;
+        void unpackResiduals();
+
+        void shrinkToFit();
+};
+
+// residual kernels are resolved once at startup to the widest instruction set the cpu supports
+
+size_t filterPositiveResiduals(const int* residuals, size_t count, uint32_t* selected);
+int minResidual(const int* residuals, const uint32_t* arcs, size_t count);
+
+size_t filterPositiveResidualsScalar(const int* residuals, size_t count, uint32_t* selected);
+int minResidualScalar(const int* residuals, const uint32_t* arcs, size_t count);
+
+const char* residualKernelName();
+
+#endif
@@ -0,0 +1,23 @@
+#include "solve_budget.hpp"
+
+bool SolveProgress::isOptimal() const
+{
+    return this->flow == this->upperBound;
+};
+
+SolveBudget SolveBudget::within(std::chrono::steady_clock::duration timeLimit)
+{
+    SolveBudget budget;
+    budget.deadline = std::chrono::steady_clock::now() + timeLimit;
+
+    return budget;
+};
+
+bool SolveBudget::isExhausted(size_t augmentations) const
+{
+    if (this->maxAugmentations && augmentations >= *this->maxAugmentations) return true;
+    if (this->cancelled && this->cancelled->load(std::memory_order_relaxed)) return true;
+    if (this->deadline && std::chrono::steady_clock::now() >= *this->deadline) return true;
+
+    return false;
+};
@@ -0,0 +1,42 @@
+#ifndef SOLVE_BUDGET
+#define SOLVE_BUDGET
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+
+class SolveProgress
+{
+    public:
+        // flow is feasible, upperBound is the capacity of a cut, so the maximum flow lies between the two
+        int flow;
+        int64_t upperBound;
+        size_t augmentations;
+        std::chrono::steady_clock::duration elapsed;
+
+        bool isOptimal() const;
+};
+
+class SolveBudget
+{
+    public:
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+        std::optional<size_t> maxAugmentations;
+
+        // may be set from any thread, the solver checks it between augmentations
+        std::shared_ptr<std::atomic<bool>> cancelled;
+
+        // onProgress runs every progressInterval augmentations, and once more when the solve stops
+        size_t progressInterval = 64;
+        std::function<void(const SolveProgress&)> onProgress;
+
+        static SolveBudget within(std::chrono::steady_clock::duration timeLimit);
+
+        bool isExhausted(size_t augmentations) const;
+};
+
+#endif
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "solver_workspace.hpp"
+
+template <typename T>
+std::span<T> allocateFromArena(std::pmr::monotonic_buffer_resource& arena, size_t count)
+{
+    return { static_cast<T*>(arena.allocate(count * sizeof(T), 64)), count };
+};
+
+size_t arenaBytes(uint32_t nodeCapacity, uint32_t degreeCapacity)
+{
+    // four node sized arrays and one degree sized array, each padded out to its alignment
+    return 4 * (nodeCapacity * sizeof(uint32_t) + 64) + degreeCapacity * sizeof(uint32_t) + 64;
+};
+
+SolverWorkspace::SolverWorkspace(uint32_t nodeCapacity, uint32_t degreeCapacity): arena(arenaBytes(nodeCapacity, degreeCapacity))
+{
+    this->nodeCapacity = nodeCapacity;
+    this->degreeCapacity = degreeCapacity;
+
+    this->visitedEpochs = allocateFromArena<uint32_t>(this->arena, nodeCapacity);
+    this->parentArcs = allocateFromArena<uint32_t>(this->arena, nodeCapacity);
+    this->queue = allocateFromArena<uint32_t>(this->arena, nodeCapacity);
+    this->path = allocateFromArena<uint32_t>(this->arena, nodeCapacity);
+    this->selected = allocateFromArena<uint32_t>(this->arena, degreeCapacity);
+
+    std::fill(this->visitedEpochs.begin(), this->visitedEpochs.end(), 0);
+    this->epoch = 1;
+    this->scannedArcs = 0;
+};
+
+// a long lived thread solving networks of many sizes would otherwise keep an arena for every size it ever saw
+constexpr size_t maxThreadSizeClasses = 2;
+
+// most recently used size class first
+std::vector<std::pair<uint64_t, std::unique_ptr<SolverWorkspace>>>& getThreadWorkspaces()
+{
+    thread_local std::vector<std::pair<uint64_t, std::unique_ptr<SolverWorkspace>>> workspacesBySizeClass;
+
+    return workspacesBySizeClass;
+};
+
+auto findThreadWorkspace(uint64_t sizeClass)
+{
+    auto& workspaces = getThreadWorkspaces();
+
+    return std::find_if(workspaces.begin(), workspaces.end(), [&](const auto& entry) { return entry.first == sizeClass; });
+};
+
+uint64_t sizeClassOf(uint32_t nodeCount, uint32_t maxDegree)
+{
+    uint32_t nodeCapacity = std::bit_ceil(std::max(nodeCount, 16u));
+    uint32_t degreeCapacity = std::bit_ceil(std::max(maxDegree, 16u));
+
+    return (static_cast<uint64_t>(nodeCapacity) << 32) | degreeCapacity;
+};
+
+SolverWorkspace& SolverWorkspace::forThread(uint32_t nodeCount, uint32_t maxDegree)
+{
+    auto& workspaces = getThreadWorkspaces();
+
+    uint64_t sizeClass = sizeClassOf(nodeCount, maxDegree);
+
+    auto found = findThreadWorkspace(sizeClass);
+
+    if (found != workspaces.end()) std::rotate(workspaces.begin(), found, found + 1);
+    else {
+        if (workspaces.size() == maxThreadSizeClasses) workspaces.pop_back();
+
+        workspaces.emplace(workspaces.begin(), sizeClass, std::make_unique<SolverWorkspace>(sizeClass >> 32, static_cast<uint32_t>(sizeClass)));
+    }
+
+    SolverWorkspace& workspace = *workspaces.front().second;
+
+    workspace.reset();
+
+    return workspace;
+};
+
+size_t SolverWorkspace::getThreadBytes()
+{
+    size_t bytes = 0;
+
+    for (const auto& [_, workspace] : getThreadWorkspaces()) bytes += sizeof(SolverWorkspace) + arenaBytes(workspace->nodeCapacity, workspace->degreeCapacity);
+
+    return bytes;
+};
+
+size_t SolverWorkspace::getThreadBytes(uint32_t nodeCount, uint32_t maxDegree)
+{
+    auto found = findThreadWorkspace(sizeClassOf(nodeCount, maxDegree));
+
+    if (found == getThreadWorkspaces().end()) return 0;
+
+    return sizeof(SolverWorkspace) + arenaBytes(found->second->nodeCapacity, found->second->degreeCapacity);
+};
+
+void SolverWorkspace::releaseThreadWorkspace(uint32_t nodeCount, uint32_t maxDegree)
+{
+    auto found = findThreadWorkspace(sizeClassOf(nodeCount, maxDegree));
+
+    if (found != getThreadWorkspaces().end()) getThreadWorkspaces().erase(found);
+};
+
+void SolverWorkspace::releaseThreadWorkspaces()
+{
+    getThreadWorkspaces().clear();
+};
+
+bool SolverWorkspace::fits(uint32_t nodeCount, uint32_t maxDegree) const
+{
+    return nodeCount <= this->nodeCapacity && maxDegree <= this->degreeCapacity;
+};
+
+void SolverWorkspace::reset()
+{
+    if (++this->epoch != 0) return;
+
+    std::fill(this->visitedEpochs.begin(), this->visitedEpochs.end(), 0);
+    this->epoch = 1;
+};
+
+bool SolverWorkspace::visit(uint32_t node)
+{
+    if (this->visitedEpochs[node] == this->epoch) return false;
+
+    this->visitedEpochs[node] = this->epoch;
+
+    return true;
+};
+
+bool SolverWorkspace::isVisited(uint32_t node) const
+{
+    return this->visitedEpochs[node] == this->epoch;
+};
@@ -0,0 +1,57 @@
+#ifndef SOLVER_WORKSPACE
+#define SOLVER_WORKSPACE
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+
+class SolverWorkspace
+{
+    private:
+        std::pmr::monotonic_buffer_resource arena;
+
+        // a node is visited when its stamp equals the current epoch, so clearing every mark is a single increment
+        uint32_t epoch;
+        std::span<uint32_t> visitedEpochs;
+
+    public:
+        uint32_t nodeCapacity;
+        uint32_t degreeCapacity;
+
+        std::span<uint32_t> parentArcs;
+        std::span<uint32_t> queue;
+        std::span<uint32_t> selected;
+        std::span<uint32_t> path;
+
+        // arcs the searches run with this workspace have scanned so far, for normalising profiles
+        uint64_t scannedArcs;
+
+        SolverWorkspace(uint32_t nodeCapacity, uint32_t degreeCapacity);
+
+        SolverWorkspace(const SolverWorkspace&) = delete;
+        SolverWorkspace& operator=(const SolverWorkspace&) = delete;
+
+        // Networks with the same rounded up size share one workspace per thread, and each thread keeps only its two
+        // most recently used size classes. The reference stays valid until forThread has been asked for two other
+        // size classes on the same thread, or the size class is released by releaseThreadWorkspace for those sizes or
+        // by releaseThreadWorkspaces, after which it must be fetched again.
+        static SolverWorkspace& forThread(uint32_t nodeCount, uint32_t maxDegree);
+
+        // bytes held on the calling thread by the workspace forThread hands out for these sizes, and a way to free it
+        static size_t getThreadBytes(uint32_t nodeCount, uint32_t maxDegree);
+        static void releaseThreadWorkspace(uint32_t nodeCount, uint32_t maxDegree);
+
+        // the same for every workspace forThread has handed out on the calling thread
+        static size_t getThreadBytes();
+        static void releaseThreadWorkspaces();
+
+        bool fits(uint32_t nodeCount, uint32_t maxDegree) const;
+
+        void reset();
+
+        bool visit(uint32_t node);
+        bool isVisited(uint32_t node) const;
+};
+
+#endif
@@ -0,0 +1,128 @@
+#include <algorithm>
+
+#include "unit_residual_bits.hpp"
+
+constexpr uint32_t rootArc = UINT32_MAX;
+
+UnitResidualBits::UnitResidualBits(const ResidualArcs& arcs)
+{
+    this->words.assign((arcs.arcCount() + 63) / 64, 0);
+
+    for (uint32_t arc = 0; arc < arcs.arcCount(); arc++) if (arcs.residual(arc) > 0) this->flip(arc);
+};
+
+bool UnitResidualBits::isUnitCapacity(const ResidualArcs& arcs)
+{
+    return std::all_of(arcs.capacities.begin(), arcs.capacities.end(), [](int capacity) { return capacity <= 1; });
+};
+
+bool UnitResidualBits::test(uint32_t arc) const
+{
+    return (this->words[arc / 64] >> (arc % 64)) & 1;
+};
+
+void UnitResidualBits::flip(uint32_t arc)
+{
+    this->words[arc / 64] ^= uint64_t(1) << (arc % 64);
+};
+
+void UnitResidualBits::store(ResidualArcs& arcs)
+{
+    arcs.residualBits = std::move(this->words);
+
+    AlignedVector<int>().swap(arcs.residuals);
+};
+
+size_t UnitResidualBits::memoryBytes() const
+{
+    return this->words.size() * sizeof(uint64_t);
+};
+
+bool maximizeUnitFlow(ResidualArcs& arcs, const std::vector<uint32_t>& sourceIndices, const std::vector<bool>& terminalMask, SolverWorkspace& workspace)
+{
+    if (!UnitResidualBits::isUnitCapacity(arcs)) return false;
+
+    UnitResidualBits bits(arcs);
+
+    std::vector<uint64_t> visitedBits((arcs.nodeCount() + 63) / 64);
+
+    auto visit = [&](uint32_t node) {
+        uint64_t mask = uint64_t(1) << (node % 64);
+
+        if (visitedBits[node / 64] & mask) return false;
+
+        visitedBits[node / 64] |= mask;
+
+        return true;
+    };
+
+    while (true) {
+        std::fill(visitedBits.begin(), visitedBits.end(), 0);
+
+        size_t queueHead = 0;
+        size_t queueTail = 0;
+
+        for (const auto& sourceIndex : sourceIndices) {
+            visit(sourceIndex);
+            workspace.parentArcs[sourceIndex] = rootArc;
+            workspace.queue[queueTail++] = sourceIndex;
+        }
+
+        uint32_t terminalIndex = rootArc;
+
+        while (queueHead < queueTail && terminalIndex == rootArc) {
+            uint32_t currNode = workspace.queue[queueHead++];
+
+            workspace.scannedArcs += arcs.offsets[currNode + 1] - arcs.offsets[currNode];
+
+            bits.forEachResidualArc(arcs.offsets[currNode], arcs.offsets[currNode + 1], [&](uint32_t arc) {
+                uint32_t neighbor = arcs.heads[arc];
+
+                if (!visit(neighbor)) return false;
+
+                workspace.parentArcs[neighbor] = arc;
+                workspace.queue[queueTail++] = neighbor;
+
+                if (terminalMask[neighbor]) terminalIndex = neighbor;
+
+                return terminalMask[neighbor];
+            });
+        }
+
+        if (terminalIndex == rootArc) break;
+
+        // every path carries exactly one unit, so augmenting moves the bit from each arc to its reverse
+        for (uint32_t currNode = terminalIndex; workspace.parentArcs[currNode] != rootArc; currNode = arcs.heads[arcs.reverses[workspace.parentArcs[currNode]]]) {
+            bits.flip(workspace.parentArcs[currNode]);
+            bits.flip(arcs.reverses[workspace.parentArcs[currNode]]);
+        }
+    }
+
+    bits.store(arcs);
+
+    return true;
+};
+
+void markUnitReachable(const ResidualArcs& arcs, const std::vector<uint32_t>& sourceIndices, SolverWorkspace& workspace)
+{
+    workspace.reset();
+
+    size_t queueTail = 0;
+
+    for (const auto& sourceIndex : sourceIndices) {
+        workspace.visit(sourceIndex);
+        workspace.queue[queueTail++] = sourceIndex;
+    }
+
+    for (size_t queueHead = 0; queueHead < queueTail; queueHead++) {
+        uint32_t currNode = workspace.queue[queueHead];
+
+        workspace.scannedArcs += arcs.offsets[currNode + 1] - arcs.offsets[currNode];
+
+        UnitResidualBits::forEachResidualArc(arcs.residualBits.data(), arcs.offsets[currNode], arcs.offsets[currNode + 1], [&](uint32_t arc) {
+            if (workspace.visit(arcs.heads[arc])) workspace.queue[queueTail++] = arcs.heads[arc];
+
+            return false;
+        });
+    }
+};
@@ -0,0 +1,61 @@
+#ifndef UNIT_RESIDUAL_BITS
+#define UNIT_RESIDUAL_BITS
+
+#include <bit>
+
+#include "residual_arcs.hpp"
+#include "solver_workspace.hpp"
+
+// When every capacity is 0 or 1 each arc's residual is a single bit, so the residual state packs 64 arcs to a word
+// laid out parallel to the arc array. Arcs leaving a node are contiguous, which turns frontier expansion into
+// scanning the set bits of a few words.
+class UnitResidualBits
+{
+    public:
+        AlignedVector<uint64_t> words;
+
+        UnitResidualBits(const ResidualArcs& arcs);
+
+        static bool isUnitCapacity(const ResidualArcs& arcs);
+
+        bool test(uint32_t arc) const;
+        void flip(uint32_t arc);
+
+        // calls visit(arc) for each residual arc in [firstArc, lastArc) until visit returns true
+        template <typename Visit>
+        bool forEachResidualArc(uint32_t firstArc, uint32_t lastArc, Visit visit) const
+        {
+            return forEachResidualArc(this->words.data(), firstArc, lastArc, visit);
+        };
+
+        // the same over words laid out like these, such as the residual bits a ResidualArcs already holds
+        template <typename Visit>
+        static bool forEachResidualArc(const uint64_t* words, uint32_t firstArc, uint32_t lastArc, Visit visit)
+        {
+            for (uint32_t wordIndex = firstArc / 64; wordIndex * 64 < lastArc; wordIndex++) {
+                uint64_t word = words[wordIndex];
+
+                if (wordIndex == firstArc / 64) word &= ~uint64_t(0) << (firstArc % 64);
+                if ((wordIndex + 1) * 64 > lastArc) word &= ~(~uint64_t(0) << (lastArc % 64));
+
+                for (; word; word &= word - 1) if (visit(wordIndex * 64 + std::countr_zero(word))) return true;
+            }
+
+            return false;
+        };
+
+        // hands the bits over to arcs as its only residual state
+        void store(ResidualArcs& arcs);
+
+        size_t memoryBytes() const;
+};
+
+// Runs the augmenting path solver over bit packed residuals and leaves arcs holding residual bits only, so the
+// int residuals, 32 times the size, are freed until something unpacks them again.
+// Returns false and leaves arcs untouched when some capacity exceeds 1.
+bool maximizeUnitFlow(ResidualArcs& arcs, const std::vector<uint32_t>& sourceIndices, const std::vector<bool>& terminalMask, SolverWorkspace& workspace);
+
+// markReachable over the residual bits arcs holds, read in place
+void markUnitReachable(const ResidualArcs& arcs, const std::vector<uint32_t>& sourceIndices, SolverWorkspace& workspace);
+
+#endif
@@ -1,6 +1,31 @@
 #include <catch2/catch_all.hpp>
 
 #include "../src/flow_capacitated_networks.hpp"
+#include "../src/flow_result_cache.hpp"
+#include "../src/network_branch.hpp"
+#include "../src/criticality_analysis.hpp"
+#include "../src/unit_residual_bits.hpp"
+#include "../src/solver_workspace.hpp"
+#include "../src/parametric_flow.hpp"
+#include "../src/fixed_flow_network.hpp"
+#include "../src/perf_counters.hpp"
+#include "../src/flow_certificate.hpp"
+#include "../src/flow_over_time.hpp"
+#include "../src/global_min_cut.hpp"
+#include "../src/mapped_network.hpp"
+#include "../src/line_server.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 TEST_CASE("CONSTRUCTIONS") {
     SECTION("EDGE CAPACITATED") {
@@ -186,12 +211,10 @@ TEST_CASE("CONSTRUCTIONS") {
 
         std::string observedNetworkStructure = network.toString();
         std::string expectedNetworkStructure =
-        "Nodes: $S, $T, A, B, C, S1, S2, T1, T2\n"
-        "Source: $S\n"
-        "Terminal: $T\n"
+        "Nodes: A, B, C, S1, S2, T1, T2\n"
+        "Sources: S1, S2\n"
+        "Terminals: T1, T2\n"
         "Capacity Matrix:\n"
-        "\tC($S, S1) = 32\n"
-        "\tC($S, S2) = 32\n"
         "\tC(A, T1) = 3\n"
         "\tC(B, T1) = 7\n"
         "\tC(C, B) = 5\n"
@@ -200,13 +223,63 @@ TEST_CASE("CONSTRUCTIONS") {
         "\tC(S1, B) = 2\n"
         "\tC(S1, C) = 4\n"
         "\tC(S2, C) = 2\n"
-        "\tC(S2, T2) = 3\n"
-        "\tC(T1, $T) = 32\n"
-        "\tC(T2, $T) = 32\n";
+        "\tC(S2, T2) = 3\n";
 
         REQUIRE(observedNetworkStructure == expectedNetworkStructure);
     }
 
+    SECTION("EDGE LIST") {
+        std::vector<Edge> edges = {
+            Edge("S1", "A", 2),
+            Edge("S1", "B", 2),
+            Edge("S1", "C", 4),
+            Edge("S2", "C", 2),
+            Edge("S2", "T2", 3),
+            Edge("A", "T1", 3),
+            Edge("B", "T1", 7),
+            Edge("C", "T2", 4),
+            Edge("C", "B", 5)
+        };
+
+        FlowCapacitatedNetwork fromSets = FlowCapacitatedNetwork::fromMultiBoundaryEdgeCapacitated(
+            { "S1", "S2", "A", "B", "C", "T1", "T2" },
+            { "S1", "S2" },
+            { "T1", "T2" },
+            std::unordered_set<Edge>(edges.begin(), edges.end())
+        );
+
+        FlowCapacitatedNetwork serial = FlowCapacitatedNetwork::fromEdgeList(edges, { "S1", "S2" }, { "T1", "T2" }, 1);
+        FlowCapacitatedNetwork parallel = FlowCapacitatedNetwork::fromEdgeList(edges, { "S1", "S2" }, { "T1", "T2" }, 4);
+
+        REQUIRE(parallel.getFingerprint() == fromSets.getFingerprint());
+        REQUIRE(parallel.getNodes() == serial.getNodes());
+        REQUIRE(parallel.getResidualArcs().heads == serial.getResidualArcs().heads);
+
+        parallel.maximizeFlow();
+
+        REQUIRE(parallel.getFlow() == 13);
+
+        // more threads than edges leaves some chunks empty
+        FlowCapacitatedNetwork sparse = FlowCapacitatedNetwork::fromEdgeList({ Edge("S", "A", 2), Edge("A", "T", 1) }, { "S" }, { "T" }, 16);
+
+        sparse.maximizeFlow();
+
+        REQUIRE(sparse.getFlow() == 1);
+
+        // far more threads than the average degree of 2 still builds the same arcs
+        std::vector<IndexedEdge> chain;
+
+        for (uint32_t node = 0; node + 1 < 1000; node++) chain.push_back({ node, node + 1, 1 });
+
+        REQUIRE(ResidualArcs(1000, chain, 64).heads == ResidualArcs(1000, chain).heads);
+
+        edges.emplace_back("A", "T1", 1);
+
+        REQUIRE_THROWS(FlowCapacitatedNetwork::fromEdgeList(edges, { "S1", "S2" }, { "T1", "T2" }, 4));
+        REQUIRE_THROWS(FlowCapacitatedNetwork::fromEdgeList({ Edge("S", "A", 1), Edge("A", "S", 1) }, { "S" }, { "T" }, 4));
+        REQUIRE_THROWS(FlowCapacitatedNetwork::fromEdgeList({ Edge("S", "T", -1) }, { "S" }, { "T" }, 4));
+    }
+
     SECTION("MULTI BOUNDARY VERTEX CAPACITATED") {
         FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromMultiBoundaryVertexCapacitated(
             { "S1", "S2", "S3", "A", "B", "C", "D", "T1", "T2" },
@@ -233,42 +306,27 @@ TEST_CASE("CONSTRUCTIONS") {
 
         std::string observedNetworkStructure = network.toString();
         std::string expectedNetworkStructure =
-        "Nodes: $S-out, $T-in, A-in, A-out, B-in, B-out, C-in, C-out, D-in, D-out, S1-in, S1-out, S2-in, S2-out, S3-in, S3-out, T1-in, T1-out, T2-in, T2-out\n"
-        "Source: $S-out\n"
-        "Terminal: $T-in\n"
+        "Nodes: A-in, A-out, B-in, B-out, C-in, C-out, D-in, D-out, S1-out, S2-out, S3-out, T1-in, T2-in\n"
+        "Sources: S1-out, S2-out, S3-out\n"
+        "Terminals: T1-in, T2-in\n"
         "Capacity Matrix:\n"
-        "\tC($S-out, S1-in) = 25\n"
-        "\tC($S-out, S2-in) = 25\n"
-        "\tC($S-out, S3-in) = 25\n"
         "\tC(A-in, A-out) = 2\n"
         "\tC(A-out, A-in) = 2\n"
-        "\tC(A-out, B-in) = 25\n"
+        "\tC(A-out, B-in) = 11\n"
         "\tC(B-in, B-out) = 9\n"
         "\tC(B-out, B-in) = 9\n"
-        "\tC(B-out, D-in) = 25\n"
-        "\tC(B-out, T1-in) = 25\n"
+        "\tC(B-out, D-in) = 11\n"
+        "\tC(B-out, T1-in) = 11\n"
         "\tC(C-in, C-out) = 11\n"
-        "\tC(C-out, B-in) = 25\n"
+        "\tC(C-out, B-in) = 11\n"
         "\tC(C-out, C-in) = 11\n"
-        "\tC(C-out, D-in) = 25\n"
+        "\tC(C-out, D-in) = 11\n"
         "\tC(D-in, D-out) = 3\n"
         "\tC(D-out, D-in) = 3\n"
-        "\tC(D-out, T2-in) = 25\n"
-        "\tC(S1-in, S1-out) = 25\n"
-        "\tC(S1-out, A-in) = 25\n"
-        "\tC(S1-out, S1-in) = 25\n"
-        "\tC(S2-in, S2-out) = 25\n"
-        "\tC(S2-out, C-in) = 25\n"
-        "\tC(S2-out, S2-in) = 25\n"
-        "\tC(S3-in, S3-out) = 25\n"
-        "\tC(S3-out, C-in) = 25\n"
-        "\tC(S3-out, S3-in) = 25\n"
-        "\tC(T1-in, T1-out) = 25\n"
-        "\tC(T1-out, $T-in) = 25\n"
-        "\tC(T1-out, T1-in) = 25\n"
-        "\tC(T2-in, T2-out) = 25\n"
-        "\tC(T2-out, $T-in) = 25\n"
-        "\tC(T2-out, T2-in) = 25\n";
+        "\tC(D-out, T2-in) = 11\n"
+        "\tC(S1-out, A-in) = 11\n"
+        "\tC(S2-out, C-in) = 11\n"
+        "\tC(S3-out, C-in) = 11\n";
 
         REQUIRE(observedNetworkStructure == expectedNetworkStructure);
     }
@@ -298,12 +356,10 @@ TEST_CASE("CONSTRUCTIONS") {
 
         std::string observedNetworkStructure = network.toString();
         std::string expectedNetworkStructure =
-        "Nodes: $S-out, $T-in, A-in, A-out, B-in, B-out, C-in, C-out, D-in, D-out, S1-in, S1-out, S2-in, S2-out, T1-in, T1-out, T2-in, T2-out\n"
-        "Source: $S-out\n"
-        "Terminal: $T-in\n"
+        "Nodes: A-in, A-out, B-in, B-out, C-in, C-out, D-in, D-out, S1-out, S2-out, T1-in, T2-in\n"
+        "Sources: S1-out, S2-out\n"
+        "Terminals: T1-in, T2-in\n"
         "Capacity Matrix:\n"
-        "\tC($S-out, S1-in) = 85\n"
-        "\tC($S-out, S2-in) = 85\n"
         "\tC(A-in, A-out) = 5\n"
         "\tC(A-out, A-in) = 5\n"
         "\tC(A-out, B-in) = 4\n"
@@ -318,20 +374,14 @@ TEST_CASE("CONSTRUCTIONS") {
         "\tC(D-in, D-out) = 8\n"
         "\tC(D-out, D-in) = 8\n"
         "\tC(D-out, T2-in) = 9\n"
-        "\tC(S1-in, S1-out) = 85\n"
         "\tC(S1-out, A-in) = 5\n"
-        "\tC(S1-out, S1-in) = 85\n"
-        "\tC(S2-in, S2-out) = 85\n"
-        "\tC(S2-out, C-in) = 10\n"
-        "\tC(S2-out, S2-in) = 85\n"
-        "\tC(T1-in, T1-out) = 85\n"
-        "\tC(T1-out, $T-in) = 85\n"
-        "\tC(T1-out, T1-in) = 85\n"
-        "\tC(T2-in, T2-out) = 85\n"
-        "\tC(T2-out, $T-in) = 85\n"
-        "\tC(T2-out, T2-in) = 85\n";
+        "\tC(S2-out, C-in) = 10\n";
 
         REQUIRE(observedNetworkStructure == expectedNetworkStructure);
+
+        // the node count alone would accept both, with B silently left out of the first
+        REQUIRE_THROWS(FlowCapacitatedNetwork::fromMultiBoundaryEdgeAndVertexCapacitated({ "S", "A", "B", "T" }, { "S", "Z" }, { "T" }, { Edge("S", "A", 1), Edge("A", "T", 1) }, { { "A", 1 } }));
+        REQUIRE_THROWS(FlowCapacitatedNetwork::fromMultiBoundaryEdgeAndVertexCapacitated({ "S", "A", "T" }, { "S", "T" }, { "T" }, { Edge("S", "A", 1) }, {}));
     }
 }
 
@@ -363,8 +413,1072 @@ TEST_CASE("SOLVER") {
         REQUIRE(sPartition == std::unordered_set<std::string>{ "S", "C" });
         REQUIRE(tPartition == std::unordered_set<std::string>{ "A", "B", "D", "T" });
     }
+
+    SECTION("MULTI BOUNDARY THROUGHPUT") {
+        FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromMultiBoundaryEdgeCapacitated(
+            { "S1", "S2", "A", "B", "C", "T1", "T2" },
+            { "S1", "S2" },
+            { "T1", "T2" },
+            {
+                Edge("S1", "A", 2),
+                Edge("S1", "B", 2),
+                Edge("S1", "C", 4),
+                Edge("S2", "C", 2),
+                Edge("S2", "T2", 3),
+                Edge("A", "T1", 3),
+                Edge("B", "T1", 7),
+                Edge("C", "T2", 4),
+                Edge("C", "B", 5)
+            }
+        );
+
+        network.maximizeFlow();
+
+        REQUIRE(network.getFlow() == 13);
+        REQUIRE(network.getSourceThroughput() == std::unordered_map<std::string, int>{ { "S1", 8 }, { "S2", 5 } });
+
+        auto terminalThroughput = network.getTerminalThroughput();
+
+        REQUIRE(terminalThroughput.size() == 2);
+        REQUIRE(terminalThroughput["T1"] + terminalThroughput["T2"] == 13);
+    }
+
+    SECTION("UNIT BIPARTITE MATCHING") {
+        std::unordered_set<std::string> nodes = { "S", "T" };
+        std::unordered_set<Edge> edges;
+
+        for (int i = 0; i < 40; i++) {
+            nodes.insert("L" + std::to_string(i));
+            nodes.insert("R" + std::to_string(i));
+            edges.emplace("S", "L" + std::to_string(i), 1);
+            edges.emplace("R" + std::to_string(i), "T", 1);
+
+            for (int j = 0; j < 40; j++) if ((i * 7 + j * 13) % 11 < 2 && j < 30) edges.emplace("L" + std::to_string(i), "R" + std::to_string(j), 1);
+        }
+
+        FlowCapacitatedNetwork matching = FlowCapacitatedNetwork::fromEdgeCapacitated(nodes, "S", "T", edges);
+
+        // a direct source -> terminal detour breaks the bipartite shape and forces the augmenting path solver
+        nodes.insert("X");
+        edges.emplace("S", "X", 1);
+        edges.emplace("X", "T", 1);
+
+        FlowCapacitatedNetwork general = FlowCapacitatedNetwork::fromEdgeCapacitated(nodes, "S", "T", edges);
+
+        matching.maximizeFlow();
+        general.maximizeFlow();
+
+        REQUIRE(matching.getFlow() == 30);
+        REQUIRE(matching.getFlow() + 1 == general.getFlow());
+        REQUIRE(matching.isMaxFlow());
+
+        auto [sPartition, tPartition] = matching.findMinCut();
+
+        REQUIRE(sPartition.size() + tPartition.size() == nodes.size() - 1);
+    }
+
+    SECTION("UNIT CAPACITY") {
+        std::unordered_set<std::string> nodes = { "S", "T" };
+        std::unordered_set<std::pair<std::string, std::string>> edges;
+        std::unordered_map<std::string, int> unitCapacity;
+        std::unordered_map<std::string, int> doubleCapacity;
+
+        auto cell = [](int row, int column) { return std::to_string(row) + "," + std::to_string(column); };
+
+        for (int row = 0; row < 8; row++) {
+            edges.insert({ "S", cell(row, 0) });
+            edges.insert({ cell(row, 7), "T" });
+
+            for (int column = 0; column < 8; column++) {
+                nodes.insert(cell(row, column));
+                unitCapacity[cell(row, column)] = 1;
+                doubleCapacity[cell(row, column)] = 2;
+
+                if (column < 7) edges.insert({ cell(row, column), cell(row, column + 1) });
+                if (row < 7) edges.insert({ cell(row, column), cell(row + 1, column) });
+                if (row > 0) edges.insert({ cell(row, column), cell(row - 1, column) });
+            }
+        }
+
+        FlowCapacitatedNetwork unit = FlowCapacitatedNetwork::fromVertexCapacitated(nodes, "S", "T", edges, unitCapacity);
+        FlowCapacitatedNetwork doubled = FlowCapacitatedNetwork::fromVertexCapacitated(nodes, "S", "T", edges, doubleCapacity);
+
+        REQUIRE(UnitResidualBits::isUnitCapacity(unit.getResidualArcs()));
+        REQUIRE(!UnitResidualBits::isUnitCapacity(doubled.getResidualArcs()));
+
+        unit.maximizeFlow();
+        doubled.maximizeFlow();
+
+        REQUIRE(unit.getFlow() == 8);
+        REQUIRE(doubled.getFlow() == 16);
+        REQUIRE(unit.isMaxFlow());
+
+        // the solved unit network keeps only its residual bits, the same topology with int residuals is far larger
+        REQUIRE(unit.getResidualArcs().hasResidualBits());
+        REQUIRE(unit.getResidualArcs().residuals.empty());
+        REQUIRE(unit.memoryUsage().flowState * 16 < doubled.memoryUsage().flowState);
+
+        REQUIRE(verifyCertificate(unit, unit.findMinCut().first).isOptimal());
+
+        unit.resetFlow();
+
+        REQUIRE(unit.getFlow() == 0);
+
+        unit.maximizeFlow();
+
+        REQUIRE(unit.getFlow() == 8);
+
+        // writing a flow unpacks the bits back into int residuals
+        unit.setFlowAssignment(unit.getFlowAssignment());
+
+        REQUIRE(!unit.getResidualArcs().hasResidualBits());
+        REQUIRE(unit.getFlow() == 8);
+        REQUIRE(unit.isMaxFlow());
+    }
+
+    SECTION("BUDGETED") {
+        FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeCapacitated(
+            { "S", "A", "B", "C", "D", "T" },
+            "S",
+            "T",
+            {
+                Edge("S", "A", 2),
+                Edge("S", "C", 4),
+                Edge("A", "B", 3),
+                Edge("A", "C", 1),
+                Edge("B", "C", 3),
+                Edge("B", "T", 4),
+                Edge("C", "D", 3),
+                Edge("D", "B", 1),
+                Edge("D", "T", 3),
+            }
+        );
+
+        SolveBudget cancelled;
+        cancelled.cancelled = std::make_shared<std::atomic<bool>>(true);
+
+        SolveProgress progress = network.maximizeFlowWithin(cancelled);
+
+        REQUIRE(progress.flow == 0);
+        REQUIRE(progress.augmentations == 0);
+        REQUIRE(progress.upperBound >= 5);
+
+        std::vector<SolveProgress> reports;
+
+        SolveBudget capped;
+        capped.maxAugmentations = 1;
+        capped.progressInterval = 1;
+        capped.onProgress = [&](const SolveProgress& report) { reports.push_back(report); };
+
+        progress = network.maximizeFlowWithin(capped);
+
+        REQUIRE(progress.augmentations == 1);
+        REQUIRE(progress.flow > 0);
+        REQUIRE(progress.flow < 5);
+        REQUIRE(progress.upperBound >= 5);
+        REQUIRE(!progress.isOptimal());
+        REQUIRE(reports.size() == 2);
+
+        progress = network.maximizeFlowWithin(SolveBudget::within(std::chrono::seconds(60)));
+
+        REQUIRE(progress.flow == 5);
+        REQUIRE(progress.isOptimal());
+    }
+}
+
+constexpr FixedFlowNetwork<6> solveFixedExample()
+{
+    enum { S, A, B, C, D, T };
+
+    FixedFlowNetwork<6> network;
+
+    network.addSource(S);
+    network.addTerminal(T);
+
+    network.addEdge(S, A, 2);
+    network.addEdge(S, C, 4);
+    network.addEdge(A, B, 3);
+    network.addEdge(A, C, 1);
+    network.addEdge(B, C, 3);
+    network.addEdge(B, T, 4);
+    network.addEdge(C, D, 3);
+    network.addEdge(D, B, 1);
+    network.addEdge(D, T, 3);
+
+    network.maximizeFlow();
+
+    return network;
+};
+
+TEST_CASE("FIXED FLOW NETWORK") {
+    SECTION("CONSTANT EXPRESSION") {
+        constexpr FixedFlowNetwork<6> network = solveFixedExample();
+
+        STATIC_REQUIRE(network.getFlow() == 5);
+        STATIC_REQUIRE(network.findMinCut() == 0b001001);
+        STATIC_REQUIRE(network.isMaxFlow());
+    }
+
+    SECTION("MULTI BOUNDARY") {
+        enum { S1, S2, A, B, C, T1, T2 };
+
+        FixedFlowNetwork<7> network;
+
+        network.addSource(S1);
+        network.addSource(S2);
+        network.addTerminal(T1);
+        network.addTerminal(T2);
+
+        network.addEdge(S1, A, 2);
+        network.addEdge(S1, B, 2);
+        network.addEdge(S1, C, 4);
+        network.addEdge(S2, C, 2);
+        network.addEdge(S2, T2, 3);
+        network.addEdge(A, T1, 3);
+        network.addEdge(B, T1, 7);
+        network.addEdge(C, T2, 4);
+        network.addEdge(C, B, 5);
+
+        network.maximizeFlow();
+
+        REQUIRE(network.getFlow() == 13);
+        REQUIRE(network.getEdgeFlow(S2, T2) == 3);
+
+        network.resetFlow();
+
+        REQUIRE(network.getFlow() == 0);
+        REQUIRE_THROWS(network.addSource(T1));
+        REQUIRE_THROWS(network.addEdge(A, A, 1));
+    }
+}
+
+TEST_CASE("CRITICALITY") {
+    using EdgeSet = std::unordered_set<std::pair<std::string, std::string>>;
+
+    SECTION("EDGE CAPACITATED") {
+        FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeCapacitated(
+            { "S", "A", "B", "C", "D", "T" },
+            "S",
+            "T",
+            {
+                Edge("S", "A", 2),
+                Edge("S", "C", 4),
+                Edge("A", "B", 3),
+                Edge("A", "C", 1),
+                Edge("B", "C", 3),
+                Edge("B", "T", 4),
+                Edge("C", "D", 3),
+                Edge("D", "B", 1),
+                Edge("D", "T", 3),
+            }
+        );
+
+        CriticalityReport report = analyzeCriticality(network);
+
+        REQUIRE(network.getFlow() == 5);
+        REQUIRE(report.downwardCriticalEdges == EdgeSet{ { "S", "A" }, { "C", "D" } });
+        REQUIRE(report.upwardCriticalEdges == EdgeSet{ { "S", "A" }, { "C", "D" } });
+    }
+
+    SECTION("PARALLEL MIN CUTS") {
+        FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeCapacitated(
+            { "S", "A", "T" },
+            "S",
+            "T",
+            {
+                Edge("S", "A", 2),
+                Edge("A", "T", 2),
+            }
+        );
+
+        CriticalityReport report = analyzeCriticality(network);
+
+        REQUIRE(report.downwardCriticalEdges == EdgeSet{ { "S", "A" }, { "A", "T" } });
+        REQUIRE(report.upwardCriticalEdges.empty());
+    }
+
+    SECTION("VERTEX CAPACITATED") {
+        FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeAndVertexCapacitated(
+            { "S", "A", "B", "T" },
+            "S",
+            "T",
+            {
+                Edge("S", "A", 5),
+                Edge("S", "B", 1),
+                Edge("A", "T", 5),
+                Edge("B", "T", 5),
+            },
+            {
+                { "A", 2 },
+                { "B", 3 },
+            }
+        );
+
+        CriticalityReport report = analyzeCriticality(network);
+
+        REQUIRE(network.getFlow() == 3);
+        REQUIRE(report.downwardCriticalVertices == std::unordered_set<std::string>{ "A" });
+        REQUIRE(report.upwardCriticalVertices == std::unordered_set<std::string>{ "A" });
+        REQUIRE(report.downwardCriticalEdges == EdgeSet{ { "S", "B" } });
+        REQUIRE(report.upwardCriticalEdges == EdgeSet{ { "S", "B" } });
+    }
+}
+
+TEST_CASE("PARAMETRIC FLOW") {
+    FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeCapacitated(
+        { "S", "A", "B", "T" },
+        "S",
+        "T",
+        {
+            Edge("S", "A", 0),
+            Edge("S", "B", 2),
+            Edge("A", "B", 1),
+            Edge("A", "T", 3),
+            Edge("B", "T", 4),
+        }
+    );
+
+    std::unordered_map<std::pair<std::string, std::string>, int> slopes = {
+        { { "S", "A" }, 1 },
+        { { "S", "B" }, 1 },
+        { { "B", "T" }, -1 },
+    };
+
+    SECTION("BREAKPOINTS AND NESTED CUTS") {
+        ParametricFlow parametricFlow = solveParametricFlow(network, slopes, 0, 4);
+
+        REQUIRE(parametricFlow.breakpoints == std::vector<double>{ 1, 3 });
+        REQUIRE(parametricFlow.cuts.size() == 3);
+        REQUIRE(parametricFlow.cuts[0].sourceSide == std::unordered_set<std::string>{ "S" });
+        REQUIRE(parametricFlow.cuts[1].sourceSide == std::unordered_set<std::string>{ "S", "B" });
+        REQUIRE(parametricFlow.cuts[2].sourceSide == std::unordered_set<std::string>{ "S", "A", "B" });
+
+        REQUIRE(parametricFlow.getFlow(0.5) == 3);
+        REQUIRE(parametricFlow.getFlow(2) == 4);
+        REQUIRE(parametricFlow.getFlow(3.5) == 3.5);
+
+        for (int lambda = 0; lambda <= 4; lambda++) {
+            FlowCapacitatedNetwork fixed = network;
+
+            fixed.setCapacity("S", "A", lambda);
+            fixed.setCapacity("S", "B", 2 + lambda);
+            fixed.setCapacity("B", "T", 4 - lambda);
+            fixed.maximizeFlow();
+
+            REQUIRE(parametricFlow.getFlow(lambda) == fixed.getFlow());
+        }
+    }
+
+    SECTION("INVALID SLOPES") {
+        REQUIRE_THROWS(solveParametricFlow(network, { { { "A", "B" }, 1 } }, 0, 4));
+        REQUIRE_THROWS(solveParametricFlow(network, { { { "S", "B" }, -1 } }, 0, 4));
+        REQUIRE_THROWS(solveParametricFlow(network, slopes, 0, 5));
+        REQUIRE_THROWS(solveParametricFlow(network, slopes, 4, 0));
+    }
+}
+
+TEST_CASE("FLOWS OVER TIME") {
+    FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeCapacitated(
+        { "S", "A", "T" },
+        "S",
+        "T",
+        {
+            Edge("S", "A", 2),
+            Edge("A", "T", 2),
+            Edge("S", "T", 1),
+        }
+    );
+
+    std::unordered_map<std::pair<std::string, std::string>, int> transitTimes = {
+        { { "S", "A" }, 1 },
+        { { "A", "T" }, 1 },
+        { { "S", "T" }, 4 },
+    };
+
+    FlowOverTimeNetwork flowOverTimeNetwork(network, transitTimes);
+
+    SECTION("MAXIMUM FLOW OVER TIME") {
+        REQUIRE(flowOverTimeNetwork.getMaxFlowValue(2) == 0);
+        REQUIRE(flowOverTimeNetwork.getMaxFlowValue(3) == 2);
+        REQUIRE(flowOverTimeNetwork.getMaxFlowValue(5) == 7);
+        REQUIRE(flowOverTimeNetwork.getMaxFlowValue(1000) == 2992);
+
+        FlowOverTime flowOverTime = flowOverTimeNetwork.maximizeFlowOverTime(5);
+
+        REQUIRE(flowOverTime.value == 7);
+        REQUIRE(flowOverTime.paths.size() == 2);
+
+        REQUIRE(flowOverTime.getEdgeFlow("S", "A", 0) == 2);
+        REQUIRE(flowOverTime.getEdgeFlow("A", "T", 3) == 2);
+        REQUIRE(flowOverTime.getEdgeFlow("A", "T", 4) == 0);
+        REQUIRE(flowOverTime.getEdgeFlow("S", "T", 0) == 1);
+        REQUIRE(flowOverTime.getEdgeFlow("S", "T", 1) == 0);
+    }
+
+    SECTION("QUICKEST FLOW") {
+        REQUIRE(flowOverTimeNetwork.findQuickestHorizon(0) == 0);
+        REQUIRE(flowOverTimeNetwork.findQuickestHorizon(7) == 5);
+        REQUIRE(flowOverTimeNetwork.findQuickestHorizon(8) == 6);
+    }
+
+    SECTION("INVALID TRANSIT TIMES") {
+        REQUIRE_THROWS(FlowOverTimeNetwork(network, { { { "S", "A" }, -1 } }));
+        REQUIRE_THROWS(FlowOverTimeNetwork(network, { { { "A", "S" }, 1 } }));
+    }
+}
+
+TEST_CASE("GLOBAL MIN CUT") {
+    FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeCapacitated(
+        { "S", "A", "B", "C", "D", "T" },
+        "S",
+        "T",
+        {
+            Edge("S", "A", 4),
+            Edge("S", "T", 4),
+            Edge("A", "T", 4),
+            Edge("A", "B", 1),
+            Edge("B", "C", 3),
+            Edge("C", "D", 3),
+            Edge("D", "B", 3),
+        }
+    );
+
+    std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> weakestCut = { { "S", "A", "T" }, { "B", "C", "D" } };
+
+    SECTION("STOER WAGNER") {
+        REQUIRE(findGlobalMinCutStoerWagner(network) == weakestCut);
+        REQUIRE(getUndirectedCutCapacity(network, weakestCut.first) == 1);
+    }
+
+    SECTION("KARGER STEIN") {
+        REQUIRE(findGlobalMinCutKargerStein(network, 1) == weakestCut);
+        REQUIRE(findGlobalMinCutKargerStein(network, 4, 7) == findGlobalMinCutKargerStein(network, 1, 7));
+    }
+
+    SECTION("DISCONNECTED") {
+        network.setCapacity("A", "B", 0);
+
+        REQUIRE(getUndirectedCutCapacity(network, findGlobalMinCutStoerWagner(network).first) == 0);
+        REQUIRE(findGlobalMinCutKargerStein(network) == weakestCut);
+    }
+}
+
+TEST_CASE("CERTIFICATES") {
+    FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeAndVertexCapacitated(
+        { "S", "A", "B", "C", "T" },
+        "S",
+        "T",
+        {
+            Edge("S", "A", 4),
+            Edge("S", "B", 2),
+            Edge("A", "C", 3),
+            Edge("B", "C", 2),
+            Edge("A", "T", 1),
+            Edge("C", "T", 5),
+        },
+        {
+            { "A", 3 },
+            { "B", 2 },
+            { "C", 4 },
+        }
+    );
+
+    network.maximizeFlow();
+
+    auto [sPartition, tPartition] = network.findMinCut();
+
+    SECTION("OPTIMAL") {
+        CertificateReport report = verifyCertificate(network, sPartition, 4);
+
+        REQUIRE(report.isOptimal());
+        REQUIRE(report.flowValue == network.getFlow());
+        REQUIRE(report.cutCapacity == report.flowValue);
+    }
+
+    SECTION("FLOW ASSIGNMENT") {
+        std::vector<int> flows = network.getFlowAssignment();
+
+        REQUIRE(verifyCertificate(network, flows, sPartition, 4).isOptimal());
+
+        std::vector<uint32_t> canonicalArcs = network.getCanonicalEdgeArcs();
+        uint32_t splitArc = network.findEdgeArc("C-in", "C-out");
+
+        size_t splitIndex = std::find(canonicalArcs.begin(), canonicalArcs.end(), splitArc) - canonicalArcs.begin();
+
+        flows[splitIndex] += 1;
+
+        CertificateReport report = verifyCertificate(network, flows, sPartition, 4);
+
+        REQUIRE(!report.isFeasible());
+        REQUIRE(report.capacityViolations == std::vector<std::pair<std::string, std::string>>{ { "C-in", "C-out" } });
+        REQUIRE(report.conservationViolations.size() == 2);
+    }
+
+    SECTION("WEAK CUTS") {
+        CertificateReport sourceOnly = verifyCertificate(network, { "S-out" }, 4);
+
+        REQUIRE(sourceOnly.isFeasible());
+        REQUIRE(sourceOnly.cutSeparates);
+        REQUIRE(sourceOnly.cutCapacity > sourceOnly.flowValue);
+        REQUIRE(!sourceOnly.isOptimal());
+
+        REQUIRE(!verifyCertificate(network, { "A-in" }, 4).cutSeparates);
+    }
+}
+
+TEST_CASE("UPDATES") {
+    FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeCapacitated(
+        { "S", "A", "B", "C", "D", "T" },
+        "S",
+        "T",
+        {
+            Edge("S", "A", 2),
+            Edge("S", "C", 4),
+            Edge("A", "B", 3),
+            Edge("A", "C", 1),
+            Edge("B", "C", 3),
+            Edge("B", "T", 4),
+            Edge("C", "D", 3),
+            Edge("D", "B", 1),
+            Edge("D", "T", 3),
+        }
+    );
+
+    network.maximizeFlow();
+
+    SECTION("CAPACITY INCREASE KEEPS FLOW") {
+        network.setCapacity("C", "D", 5);
+
+        REQUIRE(network.getFlow() == 5);
+        REQUIRE_FALSE(network.isMaxFlow());
+
+        network.maximizeFlow();
+
+        REQUIRE(network.getFlow() == 6);
+    }
+
+    SECTION("CAPACITY DECREASE BELOW FLOW") {
+        network.setCapacity("S", "A", 0);
+
+        REQUIRE(network.getFlow() == 0);
+
+        network.maximizeFlow();
+
+        REQUIRE(network.getFlow() == 3);
+    }
+
+    SECTION("BOUNDARY") {
+        network.setBoundary({ "S" }, { "T" });
+
+        REQUIRE(network.getFlow() == 0);
+
+        REQUIRE_THROWS(network.setBoundary({ "A" }, { "T" }));
+        REQUIRE_THROWS(network.setBoundary({ "S" }, { "B" }));
+        REQUIRE_THROWS(network.setCapacity("A", "S", 1));
+    }
+}
+
+TEST_CASE("BRANCHES") {
+    FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeCapacitated(
+        { "S", "A", "B", "C", "D", "T" },
+        "S",
+        "T",
+        {
+            Edge("S", "A", 2),
+            Edge("S", "C", 4),
+            Edge("A", "B", 3),
+            Edge("A", "C", 1),
+            Edge("B", "C", 3),
+            Edge("B", "T", 4),
+            Edge("C", "D", 3),
+            Edge("D", "B", 1),
+            Edge("D", "T", 3),
+        }
+    );
+
+    network.maximizeFlow();
+
+    NetworkBranch base(std::make_shared<const FlowCapacitatedNetwork>(network));
+
+    NetworkBranch dropLink = base.branch();
+    dropLink.setCapacity("C", "D", 0);
+    dropLink.maximizeFlow();
+
+    NetworkBranch widenLink = base.branch();
+    widenLink.setCapacity("S", "A", 4);
+    widenLink.maximizeFlow();
+
+    NetworkBranch widenAndDrop = widenLink.branch();
+    widenAndDrop.setCapacity("C", "D", 0);
+    widenAndDrop.maximizeFlow();
+
+    REQUIRE(base.getFlow() == 5);
+    REQUIRE(dropLink.getFlow() == 2);
+    REQUIRE(widenLink.getFlow() == 6);
+    REQUIRE(widenAndDrop.getFlow() == 3);
+
+    REQUIRE(base.getChangeCount() == 0);
+    REQUIRE(widenLink.getChangeCount() < 9);
+
+    // solving again finds no augmenting path, so nothing new is recorded
+    size_t solvedChangeCount = widenAndDrop.getChangeCount();
+
+    widenAndDrop.maximizeFlow();
+
+    REQUIRE(widenAndDrop.getChangeCount() == solvedChangeCount);
+    REQUIRE(widenAndDrop.getFlow() == 3);
+
+    auto [sPartition, tPartition] = dropLink.findMinCut();
+
+    REQUIRE(sPartition.contains("S"));
+    REQUIRE(tPartition.contains("T"));
+    REQUIRE(network.getFlow() == 5);
+}
+
+TEST_CASE("RESULT CACHE") {
+    auto buildNetwork = [](std::unordered_set<Edge> edges) {
+        return FlowCapacitatedNetwork::fromEdgeCapacitated({ "S", "A", "B", "T" }, "S", "T", edges);
+    };
+
+    SECTION("FINGERPRINT") {
+        auto network = buildNetwork({ Edge("S", "A", 2), Edge("A", "B", 1), Edge("B", "T", 2), Edge("A", "T", 1) });
+        auto reordered = buildNetwork({ Edge("A", "T", 1), Edge("B", "T", 2), Edge("S", "A", 2), Edge("A", "B", 1) });
+        auto reversed = buildNetwork({ Edge("S", "A", 2), Edge("B", "A", 1), Edge("B", "T", 2), Edge("A", "T", 1) });
+
+        REQUIRE(network.getFingerprint() == reordered.getFingerprint());
+        REQUIRE(network.getFingerprint() != reversed.getFingerprint());
+        REQUIRE(std::hash<Edge>()(Edge("A", "B", 1)) != std::hash<Edge>()(Edge("B", "A", 1)));
+
+        uint64_t original = network.getFingerprint();
+
+        network.setCapacity("A", "B", 3);
+        REQUIRE(network.getFingerprint() != original);
+
+        network.setCapacity("A", "B", 1);
+        REQUIRE(network.getFingerprint() == original);
+    }
+
+    SECTION("LRU") {
+        FlowResultCache cache(2);
+
+        auto first = buildNetwork({ Edge("S", "A", 2), Edge("A", "B", 1), Edge("B", "T", 2), Edge("A", "T", 1) });
+        auto second = buildNetwork({ Edge("S", "A", 5), Edge("A", "T", 4) });
+        auto third = buildNetwork({ Edge("S", "B", 3), Edge("B", "T", 3) });
+
+        cache.maximizeFlow(first);
+        cache.maximizeFlow(second);
+
+        auto firstAgain = buildNetwork({ Edge("A", "T", 1), Edge("B", "T", 2), Edge("S", "A", 2), Edge("A", "B", 1) });
+        auto [sPartition, tPartition] = cache.findMinCut(firstAgain);
+
+        REQUIRE(cache.getHits() == 1);
+        REQUIRE(firstAgain.getFlow() == 2);
+        REQUIRE(firstAgain.isMaxFlow());
+        REQUIRE(sPartition == std::unordered_set<std::string>{ "S" });
+
+        cache.maximizeFlow(third);
+        REQUIRE(cache.size() == 2);
+
+        cache.maximizeFlow(second);
+        REQUIRE(cache.getMisses() == 4);
+        REQUIRE(second.getFlow() == 4);
+    }
+}
+
+TEST_CASE("RESIDUAL ARCS") {
+    SECTION("KERNELS MATCH SCALAR") {
+        std::vector<int> residuals;
+        for (int i = 0; i < 1000; i++) residuals.push_back((i * 7919) % 13 - 4);
+
+        for (size_t count : { 0, 1, 7, 8, 15, 16, 17, 100, 1000 }) {
+            std::vector<uint32_t> observedSelected(count);
+            std::vector<uint32_t> expectedSelected(count);
+
+            size_t observedCount = filterPositiveResiduals(residuals.data(), count, observedSelected.data());
+            size_t expectedCount = filterPositiveResidualsScalar(residuals.data(), count, expectedSelected.data());
+
+            observedSelected.resize(observedCount);
+            expectedSelected.resize(expectedCount);
+
+            REQUIRE(observedSelected == expectedSelected);
+
+            std::vector<uint32_t> arcs;
+            for (size_t i = 0; i < count; i++) arcs.push_back((i * 31) % 1000);
+
+            REQUIRE(minResidual(residuals.data(), arcs.data(), count) == minResidualScalar(residuals.data(), arcs.data(), count));
+        }
+    }
+
+    SECTION("HUB NODE") {
+        std::unordered_set<std::string> nodes = { "S", "H", "T" };
+        std::unordered_set<Edge> edges = { Edge("S", "H", 50000) };
+
+        for (int i = 0; i < 20000; i++) {
+            std::string node = "N" + std::to_string(i);
+
+            nodes.emplace(node);
+            edges.emplace("H", node, i % 3);
+            edges.emplace(node, "T", 1);
+        }
+
+        FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeCapacitated(nodes, "S", "T", edges);
+
+        network.maximizeFlow();
+
+        REQUIRE(network.getFlow() == 13333);
+        REQUIRE(network.isMaxFlow());
+    }
+}
+
+TEST_CASE("MEMORY") {
+    FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromMultiBoundaryEdgeCapacitated(
+        { "S1", "S2", "A", "B", "C", "T1", "T2" },
+        { "S1", "S2" },
+        { "T1", "T2" },
+        {
+            Edge("S1", "A", 2),
+            Edge("S1", "B", 2),
+            Edge("S1", "C", 4),
+            Edge("S2", "C", 2),
+            Edge("S2", "T2", 3),
+            Edge("A", "T1", 3),
+            Edge("B", "T1", 7),
+            Edge("C", "T2", 4),
+            Edge("C", "B", 5)
+        }
+    );
+
+    network.maximizeFlow();
+
+    MemoryUsage solved = network.memoryUsage();
+
+    REQUIRE(solved.arcs > 0);
+    REQUIRE(solved.flowState >= 18 * sizeof(int));
+    REQUIRE(solved.scratch > 0);
+    REQUIRE(solved.total() == solved.nodes + solved.arcs + solved.flowState + solved.caches);
+
+    SolverWorkspace& other = SolverWorkspace::forThread(4096, 64);
+
+    auto minCut = network.findMinCut();
+    auto terminalThroughput = network.getTerminalThroughput();
+
+    network.compact(true);
+
+    MemoryUsage compacted = network.memoryUsage();
+
+    REQUIRE(compacted.caches < solved.caches);
+    REQUIRE(compacted.scratch == 0);
+    REQUIRE(compacted.total() < solved.total());
+    REQUIRE(SolverWorkspace::getThreadBytes(4096, 64) > 0);
+
+    other.reset();
+    other.visit(4000);
+
+    REQUIRE(other.isVisited(4000));
+
+    REQUIRE(network.getFlow() == 13);
+    REQUIRE(network.getTerminalThroughput() == terminalThroughput);
+    REQUIRE(network.findMinCut() == minCut);
+    REQUIRE_THROWS(NetworkBranch(std::make_shared<FlowCapacitatedNetwork>(network)));
+
+    network.setCapacity("S2", "T2", 5);
+    network.maximizeFlow();
+
+    REQUIRE(network.getResidualArcs().hasReverses());
+    REQUIRE(network.getFlow() == 15);
+    REQUIRE(network.isMaxFlow());
+}
+
+TEST_CASE("MAPPED NETWORK") {
+    FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromMultiBoundaryEdgeCapacitated(
+        { "S1", "S2", "A", "B", "C", "T1", "T2" },
+        { "S1", "S2" },
+        { "T1", "T2" },
+        {
+            Edge("S1", "A", 2),
+            Edge("S1", "B", 2),
+            Edge("S1", "C", 4),
+            Edge("S2", "C", 2),
+            Edge("S2", "T2", 3),
+            Edge("A", "T1", 3),
+            Edge("B", "T1", 7),
+            Edge("C", "T2", 4),
+            Edge("C", "B", 5)
+        }
+    );
+
+    std::string path = (std::filesystem::temp_directory_path() / "mapped_network_test.net").string();
+    std::string reorderedPath = (std::filesystem::temp_directory_path() / "mapped_network_test_reordered.net").string();
+
+    MappedNetwork::write(path, network);
+
+    network.maximizeFlow();
+
+    SECTION("SOLVE") {
+        MappedNetwork mapped(path);
+
+        REQUIRE(mapped.nodeCount() == 7);
+        REQUIRE(mapped.arcCount() == 18);
+        REQUIRE(mapped.getResidentBytes() < mapped.getMappedBytes());
+
+        mapped.maximizeFlow();
+
+        REQUIRE(mapped.getFlow() == network.getFlow());
+
+        std::vector<bool> sourceSide = mapped.findMinCut();
+        std::unordered_set<std::string> sourceSideNames;
+
+        for (uint32_t node = 0; node < sourceSide.size(); node++) if (sourceSide[node]) sourceSideNames.insert(network.getNodes()[node]);
+
+        REQUIRE(sourceSideNames == network.findMinCut().first);
+
+        mapped.resetFlow();
+
+        REQUIRE(mapped.getFlow() == 0);
+    }
+
+    SECTION("BREADTH FIRST ORDER") {
+        MappedNetwork mapped(path);
+
+        std::vector<uint32_t> order = mapped.breadthFirstOrder();
+
+        for (uint32_t source : network.getSourceIndices()) REQUIRE(order[source] < 2);
+
+        mapped.writeReordered(reorderedPath, order);
+
+        MappedNetwork reordered(reorderedPath);
+        reordered.maximizeFlow();
+
+        REQUIRE(reordered.getFlow() == network.getFlow());
+    }
+
+    SECTION("INVALID FILES") {
+        auto edges = [](const MappedNetwork::EdgeVisitor& visit) { visit(1, 0, 1); };
+
+        REQUIRE_THROWS(MappedNetwork::write(reorderedPath, 2, { 0 }, { 1 }, edges));
+        REQUIRE_THROWS(MappedNetwork::write(reorderedPath, 2, { 0 }, { 0 }, [](const MappedNetwork::EdgeVisitor&) {}));
+        REQUIRE_THROWS(MappedNetwork(reorderedPath + ".missing"));
+
+        REQUIRE_THROWS(MappedNetwork::write(reorderedPath, network, { 0, 0, 2, 3, 4, 5, 6 }));
+        REQUIRE_THROWS(MappedNetwork::write(reorderedPath, network, { 0, 1, 2, 3, 4, 5, 7 }));
+        REQUIRE(!std::filesystem::exists(reorderedPath));
+
+        int passes = 0;
+
+        auto changingEdges = [&](const MappedNetwork::EdgeVisitor& visit) {
+            visit(0, 1, 1);
+
+            if (++passes > 1) visit(0, 1, 1);
+        };
+
+        REQUIRE_THROWS(MappedNetwork::write(reorderedPath, 2, { 0 }, { 1 }, changingEdges));
+        REQUIRE(!std::filesystem::exists(reorderedPath));
+
+        // the terminal indices sit in the last cache line of the file
+        std::filesystem::copy_file(path, reorderedPath);
+
+        std::fstream file(reorderedPath, std::ios::in | std::ios::out | std::ios::binary);
+        uint32_t outOfRange = 99;
+
+        file.seekp(std::filesystem::file_size(reorderedPath) - 64);
+        file.write(reinterpret_cast<const char*>(&outOfRange), sizeof(outOfRange));
+        file.close();
+
+        REQUIRE_THROWS(MappedNetwork(reorderedPath));
+
+        // the heads start on the cache line after the header and the eight offsets
+        std::filesystem::copy_file(path, reorderedPath, std::filesystem::copy_options::overwrite_existing);
+
+        file.open(reorderedPath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(128);
+        file.write(reinterpret_cast<const char*>(&outOfRange), sizeof(outOfRange));
+        file.close();
+
+        REQUIRE_THROWS(MappedNetwork(reorderedPath));
+    }
+
+    SECTION("REPLACING FILES") {
+        MappedNetwork mapped(path);
+
+        mapped.writeReordered(path, mapped.breadthFirstOrder());
+
+        MappedNetwork reordered(path);
+
+        mapped.maximizeFlow();
+        reordered.maximizeFlow();
+
+        REQUIRE(mapped.getFlow() == network.getFlow());
+        REQUIRE(reordered.getFlow() == network.getFlow());
+
+        int passes = 0;
+
+        auto changingEdges = [&](const MappedNetwork::EdgeVisitor& visit) {
+            visit(0, 1, 1);
+
+            if (++passes > 1) visit(0, 1, 1);
+        };
+
+        REQUIRE_THROWS(MappedNetwork::write(path, 2, { 0 }, { 1 }, changingEdges));
+        REQUIRE(MappedNetwork(path).nodeCount() == 7);
+
+        for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::temp_directory_path())) {
+            REQUIRE(!entry.path().filename().string().starts_with("mapped_network_test.net."));
+        }
+    }
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(reorderedPath);
+}
+
+TEST_CASE("SOLVER WORKSPACE") {
+    SECTION("SHARED ACROSS SOLVES") {
+        SolverWorkspace workspace(16, 16);
+
+        for (int i = 0; i < 3; i++) {
+            FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeCapacitated(
+                { "S", "A", "B", "T" },
+                "S",
+                "T",
+                {
+                    Edge("S", "A", 3),
+                    Edge("S", "B", 1 + i),
+                    Edge("A", "B", 1),
+                    Edge("A", "T", 2),
+                    Edge("B", "T", 4),
+                }
+            );
+
+            network.maximizeFlow(workspace);
+
+            REQUIRE(network.getFlow() == 4 + i);
+        }
+
+        REQUIRE(&SolverWorkspace::forThread(10, 3) == &SolverWorkspace::forThread(12, 5));
+        REQUIRE(&SolverWorkspace::forThread(10, 3) != &SolverWorkspace::forThread(40, 3));
+
+        // only the two most recently used size classes stay with the thread
+        SolverWorkspace::forThread(10, 3);
+        SolverWorkspace::forThread(40, 3);
+        SolverWorkspace::forThread(200, 3);
+
+        REQUIRE(SolverWorkspace::getThreadBytes(10, 3) == 0);
+        REQUIRE(SolverWorkspace::getThreadBytes() == SolverWorkspace::getThreadBytes(40, 3) + SolverWorkspace::getThreadBytes(200, 3));
+    }
+
+    SECTION("SCANNED ARCS") {
+        FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeCapacitated({ "S", "A", "T" }, "S", "T", { Edge("S", "A", 2), Edge("A", "T", 1) });
+
+        SolverWorkspace workspace(3, 2);
+
+        network.maximizeFlow(workspace);
+
+        REQUIRE(workspace.scannedArcs >= network.getResidualArcs().arcCount());
+    }
+
+    SECTION("TOO SMALL") {
+        SolverWorkspace workspace(2, 2);
+
+        FlowCapacitatedNetwork network = FlowCapacitatedNetwork::fromEdgeCapacitated({ "S", "A", "T" }, "S", "T", { Edge("S", "A", 1), Edge("A", "T", 1) });
+
+        REQUIRE_THROWS(network.maximizeFlow(workspace));
+    }
+}
+
+TEST_CASE("PERF COUNTERS") {
+    PerfCounters counters;
+
+    counters.start();
+
+    std::vector<std::optional<uint64_t>> readings = counters.stop();
+
+    REQUIRE(readings.size() == PerfCounters::getCounterNames().size());
+
+    if (!counters.isAvailable()) for (const auto& reading : readings) REQUIRE(!reading);
+}
+
+TEST_CASE("LINE SERVER") {
+    std::string path = (std::filesystem::temp_directory_path() / "line_server_test.sock").string();
+
+    std::atomic<bool> stopped = false;
+
+    LineServer server(path);
+
+    std::thread serving([&]() {
+        while (!stopped) server.serveOnce([](std::string line) { return "ok " + line; }, 20);
+    });
+
+    auto connectClient = [&]() {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, path.c_str());
+
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            close(fd);
+            return -1;
+        }
+
+        return fd;
+    };
+
+    int stalled = connectClient();
+    int active = connectClient();
+
+    // far more replies than the socket buffers hold, none of which the stalled client reads past the first 250KB
+    std::string queries;
+
+    for (int i = 0; i < 120000; i++) queries += "list\n";
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+
+    for (size_t sent = 0; stalled >= 0 && sent < queries.size() && std::chrono::steady_clock::now() < deadline;) {
+        ssize_t sendCount = send(stalled, queries.data() + sent, queries.size() - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+        if (sendCount > 0) sent += sendCount;
+        else std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // reading a little lets the server write again, and a blocking write of the rest would then never return
+    size_t stalledReadBytes = 0;
+    pollfd stalledReadable { stalled, POLLIN, 0 };
+
+    while (stalled >= 0 && stalledReadBytes < 250000 && poll(&stalledReadable, 1, 3000) > 0) {
+        char buffer[4096];
+        ssize_t readCount = read(stalled, buffer, sizeof(buffer));
+
+        if (readCount <= 0) break;
+
+        stalledReadBytes += readCount;
+    }
+
+    std::string reply;
+    pollfd activeReadable { active, POLLIN, 0 };
+
+    if (active >= 0 && send(active, "maxflow g\n", 10, MSG_NOSIGNAL) == 10) {
+        while (reply.find('\n') == std::string::npos && poll(&activeReadable, 1, 3000) > 0) {
+            char buffer[256];
+            ssize_t readCount = read(active, buffer, sizeof(buffer));
+
+            if (readCount <= 0) break;
+
+            reply.append(buffer, readCount);
+        }
+    }
+
+    // closing first lets a server stuck writing to the stalled client return before the join
+    if (stalled >= 0) close(stalled);
+    if (active >= 0) close(active);
+
+    stopped = true;
+    serving.join();
+
+    REQUIRE(stalled >= 0);
+    REQUIRE(active >= 0);
+    REQUIRE(stalledReadBytes >= 250000);
+    REQUIRE(reply == "ok maxflow g\n");
 }
 
 int main() {
     return Catch::Session().run();
-}
\ No newline at end of file
+}